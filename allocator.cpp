@@ -0,0 +1,178 @@
+// Allocator for large arrays (huge pages, NUMA placement)
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "allocator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace memory
+{
+
+namespace
+{
+	std::atomic<HugePages> g_hugePages(HUGEPAGES_NONE);
+	std::atomic<Placement> g_placement(PLACEMENT_DEFAULT);
+
+	// Warn only once if explicit huge pages are not available
+	std::atomic<bool> g_hugeTLBWarning(false);
+
+	// Size of each mapping created by allocate(), which may be larger than
+	// the requested size for explicit huge pages
+	std::mutex g_mappingMutex;
+	std::unordered_map<void*, std::size_t> g_mappings;
+
+	const std::size_t HugePageSize = 2u << 20;
+
+	//! Bit mask of the online NUMA nodes (at most 64 are supported)
+	uint64_t onlineNodes()
+	{
+		static uint64_t mask = 0;
+		if(mask)
+			return mask;
+
+		// Format: "0-3,5"
+		std::ifstream stream("/sys/devices/system/node/online");
+		std::string range;
+		uint64_t result = 0;
+		while(std::getline(stream, range, ','))
+		{
+			unsigned int first, last;
+			int n = sscanf(range.c_str(), "%u-%u", &first, &last);
+			if(n == 1)
+				last = first;
+			else if(n != 2)
+				continue;
+
+			for(unsigned int node = first; node <= last && node < 64; ++node)
+				result |= uint64_t(1) << node;
+		}
+
+		mask = result ? result : 1;
+		return mask;
+	}
+
+	void applyPlacement(void* ptr, std::size_t size)
+	{
+		Placement mode = g_placement;
+		if(mode == PLACEMENT_DEFAULT)
+			return;
+
+		uint64_t nodes = onlineNodes();
+
+		// Nothing to do on single-node machines
+		if(!(nodes & (nodes - 1)))
+			return;
+
+		int ret;
+		if(mode == PLACEMENT_INTERLEAVE)
+			ret = syscall(SYS_mbind, ptr, size, MPOL_INTERLEAVE, &nodes, 64, 0);
+		else
+			ret = syscall(SYS_mbind, ptr, size, MPOL_LOCAL, 0, 0, 0);
+
+		if(ret != 0)
+			perror("mbind");
+	}
+}
+
+void setHugePages(HugePages mode)
+{
+	g_hugePages = mode;
+}
+
+HugePages hugePages()
+{
+	return g_hugePages;
+}
+
+void setPlacement(Placement mode)
+{
+	g_placement = mode;
+}
+
+Placement placement()
+{
+	return g_placement;
+}
+
+void* allocate(std::size_t size)
+{
+	if(size < LargeAllocationSize)
+		return ::operator new(size);
+
+	HugePages huge = g_hugePages;
+	std::size_t mappedSize = size;
+	void* ptr = MAP_FAILED;
+
+	if(huge == HUGEPAGES_EXPLICIT)
+	{
+		// MAP_HUGETLB needs a multiple of the huge page size
+		mappedSize = (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+		ptr = mmap(0, mappedSize, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+		if(ptr == MAP_FAILED && !g_hugeTLBWarning.exchange(true))
+			fprintf(stderr, "Warning: Could not allocate explicit huge pages, using transparent huge pages\n");
+	}
+
+	if(ptr == MAP_FAILED)
+	{
+		mappedSize = size;
+		ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(ptr == MAP_FAILED)
+			throw std::bad_alloc();
+
+		if(huge != HUGEPAGES_NONE)
+			madvise(ptr, size, MADV_HUGEPAGE);
+	}
+
+	// The placement has to be set before the pages are touched
+	applyPlacement(ptr, mappedSize);
+
+	std::unique_lock<std::mutex> lock(g_mappingMutex);
+	g_mappings[ptr] = mappedSize;
+
+	return ptr;
+}
+
+void deallocate(void* ptr, std::size_t size)
+{
+	if(!ptr)
+		return;
+
+	if(size < LargeAllocationSize)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	std::size_t mappedSize;
+	{
+		std::unique_lock<std::mutex> lock(g_mappingMutex);
+		auto it = g_mappings.find(ptr);
+		if(it == g_mappings.end())
+		{
+			// Not allocated by allocate(), or freed twice
+			fprintf(stderr, "memory::deallocate(): unknown pointer %p\n", ptr);
+			abort();
+		}
+
+		mappedSize = it->second;
+		g_mappings.erase(it);
+	}
+
+	munmap(ptr, mappedSize);
+}
+
+}
@@ -0,0 +1,95 @@
+// Allocator for large arrays (huge pages, NUMA placement)
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Process-wide policy for large allocations (see LargeAllocator).
+ *
+ * The random access pattern of the matching algorithm causes many TLB
+ * misses on multi-GB arrays, which huge pages avoid. On multi-socket
+ * machines, pages can additionally be interleaved across NUMA nodes, so
+ * that not all accesses hit the memory of the first-touching socket.
+ **/
+namespace memory
+{
+	enum HugePages
+	{
+		HUGEPAGES_NONE,        //!< normal pages (default)
+		HUGEPAGES_TRANSPARENT, //!< madvise(MADV_HUGEPAGE)
+		HUGEPAGES_EXPLICIT     //!< MAP_HUGETLB, falls back to transparent
+	};
+
+	enum Placement
+	{
+		PLACEMENT_DEFAULT,    //!< first touch (default)
+		PLACEMENT_INTERLEAVE, //!< interleave pages across all NUMA nodes
+		PLACEMENT_LOCAL       //!< NUMA node of the allocating thread
+	};
+
+	void setHugePages(HugePages mode);
+	HugePages hugePages();
+
+	void setPlacement(Placement mode);
+	Placement placement();
+
+	/**
+	 * Allocations of at least this size are mapped directly and follow the
+	 * policy, smaller ones use operator new. Large allocations are few, so
+	 * the bookkeeping overhead does not matter.
+	 *
+	 * Structures made of many small blocks are not covered by the policy:
+	 * the adjacency lists of Graph (use a CSR representation instead) and
+	 * the per-tree and per-blossom lists of BasicEdmondsMatching.
+	 **/
+	static const std::size_t LargeAllocationSize = 2u << 20;
+
+	//! Allocate @a size bytes according to the current policy
+	void* allocate(std::size_t size);
+
+	//! Free memory returned by allocate() (@a size as passed to allocate())
+	void deallocate(void* ptr, std::size_t size);
+}
+
+/**
+ * STL allocator which places large arrays according to the memory policy
+ * set in the memory namespace.
+ **/
+template<class T>
+class LargeAllocator
+{
+public:
+	typedef T value_type;
+
+	LargeAllocator()
+	{}
+
+	template<class U>
+	LargeAllocator(const LargeAllocator<U>&)
+	{}
+
+	T* allocate(std::size_t n)
+	{ return reinterpret_cast<T*>(memory::allocate(n * sizeof(T))); }
+
+	void deallocate(T* ptr, std::size_t n)
+	{ memory::deallocate(ptr, n * sizeof(T)); }
+
+	template<class U>
+	bool operator==(const LargeAllocator<U>&) const
+	{ return true; }
+
+	template<class U>
+	bool operator!=(const LargeAllocator<U>&) const
+	{ return false; }
+};
+
+//! std::vector using LargeAllocator
+template<class T>
+using LargeVector = std::vector<T, LargeAllocator<T>>;
+
+#endif
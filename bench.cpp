@@ -0,0 +1,642 @@
+// Benchmark for the different graph representations
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "graph.h"
+#include "edmonds.h"
+#include "mapped_graph.h"
+#include "compressed_input.h"
+#include "weighted_matching.h"
+#include "ingestion.h"
+#include "sparsify.h"
+#include "dense_graph.h"
+#include "csr_builder.h"
+#include "memory_usage.h"
+
+#ifdef HAVE_BOOST
+#include "boost_graph.h"
+#include "edmonds_impl.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+
+//! Loader for the ingestion benchmark
+struct IngestionLoader
+{
+	explicit IngestionLoader(bool match)
+	 : matchWhileLoading(match)
+	{}
+
+	void header(NodeID numNodes, std::size_t)
+	{
+		graph.reset(numNodes);
+		if(matchWhileLoading)
+			greedy.reset(numNodes);
+	}
+
+	void edge(NodeID v, NodeID w)
+	{
+		graph.addEdge(v, w);
+		if(matchWhileLoading)
+			greedy.edge(v, w);
+	}
+
+	bool matchWhileLoading;
+	Graph graph;
+	OnlineGreedyMatching greedy;
+};
+
+//! parseGraph() handler which builds compact CSR arrays (see --max-memory)
+struct CSRLoader
+{
+	void header(NodeID numNodes, std::size_t numEdges)
+	{ builder.reset(numNodes, numEdges); }
+
+	void edge(NodeID v, NodeID w)
+	{ builder.addEdge(v, w); }
+
+	CSRGraphBuilder<uint32_t> builder;
+};
+
+static unsigned int g_runs = 5;
+static double g_baseline = 0.0;
+
+/**
+ * Counts data TLB misses of the calling thread using perf events. If perf
+ * events are not available (e.g. kernel.perf_event_paranoid), valid()
+ * returns false.
+ **/
+class TLBCounter
+{
+public:
+	TLBCounter()
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_DTLB
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		m_fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+
+	~TLBCounter()
+	{
+		if(m_fd >= 0)
+			close(m_fd);
+	}
+
+	bool valid() const
+	{ return m_fd >= 0; }
+
+	void start()
+	{
+		if(m_fd < 0)
+			return;
+		ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+
+	uint64_t stop()
+	{
+		uint64_t count = 0;
+		if(m_fd < 0)
+			return 0;
+		ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+		if(read(m_fd, &count, sizeof(count)) != sizeof(count))
+			return 0;
+		return count;
+	}
+private:
+	int m_fd;
+};
+
+static void printHeader(const char* title)
+{
+	g_baseline = 0.0;
+	printf("\n%s\n", title);
+	printf("%-24s %10s %12s %12s %9s %14s\n",
+		"variant", "size", "best [ms]", "mean [ms]", "speedup", "dTLB misses"
+	);
+}
+
+/**
+ * Triangular lattice with @a width x @a height nodes, of which a fraction
+ * of @a holes is removed. Lattices have many short odd cycles and a large
+ * diameter, so the search shrinks many nested blossoms in deep trees.
+ **/
+static void triangularLattice(Graph* graph, unsigned int width, unsigned int height, double holes, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+	const NodeID None = ~NodeID(0);
+	std::vector<NodeID> ids(width * height, None);
+	NodeID numNodes = 0;
+	for(std::size_t i = 0; i < ids.size(); ++i)
+	{
+		if(uniform(rng) >= holes)
+			ids[i] = numNodes++;
+	}
+
+	std::vector<Graph::Edge> edges;
+	for(unsigned int y = 0; y < height; ++y)
+	{
+		for(unsigned int x = 0; x < width; ++x)
+		{
+			NodeID v = ids[y * width + x];
+			if(v == None)
+				continue;
+
+			const int offsets[3][2] = {{1, 0}, {0, 1}, {1, 1}};
+			for(const auto& d : offsets)
+			{
+				if(x + d[0] >= width || y + d[1] >= height)
+					continue;
+
+				NodeID w = ids[(y + d[1]) * width + x + d[0]];
+				if(w != None)
+					edges.emplace_back(v, w);
+			}
+		}
+	}
+
+	// Random edge order, as in typical input files
+	std::shuffle(edges.begin(), edges.end(), rng);
+
+	graph->reset(numNodes);
+	for(const Graph::Edge& e : edges)
+		graph->addEdge(e.first, e.second);
+}
+
+/**
+ * Run @a func g_runs times and print the best and mean runtime and the
+ * mean number of dTLB misses. @a func returns the matching size.
+ *
+ * @return Best runtime in ms
+ **/
+template<class Func>
+static double benchmark(const char* name, Func func)
+{
+	double best = 1e100;
+	double sum = 0.0;
+	std::size_t size = 0;
+	uint64_t tlbMisses = 0;
+	TLBCounter counter;
+
+	for(unsigned int i = 0; i < g_runs; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		counter.start();
+		size = func();
+		tlbMisses += counter.stop();
+		auto end = std::chrono::steady_clock::now();
+
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		best = std::min(best, ms);
+		sum += ms;
+	}
+
+	if(g_baseline == 0.0)
+		g_baseline = best;
+
+	char tlb[32] = "n/a";
+	if(counter.valid())
+		snprintf(tlb, sizeof(tlb), "%lu", tlbMisses / g_runs);
+
+	printf("%-24s %10lu %12.2f %12.2f %8.2fx %14s\n",
+		name, size, best, sum / g_runs, g_baseline / best, tlb
+	);
+
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	const char* inputFile = 0;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(!strcmp(argv[i], "--runs") && i+1 < argc)
+			g_runs = std::max(1ul, strtoul(argv[++i], 0, 10));
+		else if(argv[i][0] != '-' && !inputFile)
+			inputFile = argv[i];
+		else
+		{
+			fprintf(stderr, "Usage: bench [--runs N] <input DIMAC file>\n");
+			return 1;
+		}
+	}
+
+	if(!inputFile)
+	{
+		fprintf(stderr, "Usage: bench [--runs N] <input DIMAC file>\n");
+		return 1;
+	}
+
+	Graph graph;
+	std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+	graph.load(*stream);
+	stream.reset();
+
+	printf("Graph with %u nodes and %u edges, %u runs\n", graph.numNodes(), graph.numEdges(), g_runs);
+	printHeader("Graph representations");
+
+	// Native Graph (baseline)
+	{
+		EdmondsCardinalityMatching edmond;
+		benchmark("Graph", [&]() { return edmond.calculateMatching(graph); });
+	}
+
+	// CSR arrays
+	{
+		std::vector<uint32_t> offsets(1, 0);
+		std::vector<uint32_t> neighbors;
+		for(NodeID v = 0; v < graph.numNodes(); ++v)
+		{
+			neighbors.insert(neighbors.end(), graph.neighbors(v).begin(), graph.neighbors(v).end());
+			offsets.push_back(neighbors.size());
+		}
+
+		CSRGraph<uint32_t> csr(graph.numNodes(), offsets.data(), neighbors.data());
+		BasicEdmondsMatching<CSRGraph<uint32_t>> edmond;
+		benchmark("CSRGraph<uint32_t>", [&]() { return edmond.calculateMatching(csr); });
+	}
+
+	// Memory-mapped binary CSR file
+	{
+		char path[] = "/tmp/edmonds-bench-XXXXXX";
+		int fd = mkstemp(path);
+		if(fd < 0)
+		{
+			perror("Could not create temporary file");
+			return 1;
+		}
+		close(fd);
+
+		if(!MappedGraph::write(graph, path))
+		{
+			perror("Could not write temporary file");
+			return 1;
+		}
+
+		MappedGraph mapped;
+		mapped.open(path);
+		unlink(path);
+
+		if(mapped.is64Bit())
+		{
+			CSRGraph<uint64_t> view = mapped.view64();
+			BasicEdmondsMatching<CSRGraph<uint64_t>> edmond;
+			benchmark("MappedGraph (64 bit)", [&]() { return edmond.calculateMatching(view); });
+		}
+		else
+		{
+			CSRGraph<uint32_t> view = mapped.view32();
+			BasicEdmondsMatching<CSRGraph<uint32_t>> edmond;
+			benchmark("MappedGraph (32 bit)", [&]() { return edmond.calculateMatching(view); });
+		}
+	}
+
+#ifdef HAVE_BOOST
+	// Boost.Graph adjacency_list
+	{
+		typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> BGraph;
+		BGraph bGraph(graph.numNodes());
+		for(const Graph::Edge& e : graph.edges())
+			boost::add_edge(e.first, e.second, bGraph);
+
+		BoostGraph<BGraph> view(bGraph);
+		BasicEdmondsMatching<BoostGraph<BGraph>> edmond;
+		benchmark("BoostGraph", [&]() { return edmond.calculateMatching(view); });
+	}
+#endif
+
+	// Tree invalidation after augmentations
+	{
+		printHeader("Tree invalidation (Graph)");
+
+		std::size_t eagerWork = 0;
+		EdmondsCardinalityMatching eager;
+		eager.setLazyInvalidation(false);
+		benchmark("eager requeue", [&]() {
+			std::size_t size = eager.calculateMatching(graph);
+			eagerWork = eager.requeueWork();
+			return size;
+		});
+
+		std::size_t lazyWork = 0;
+		EdmondsCardinalityMatching lazy;
+		benchmark("lazy (dirty vertices)", [&]() {
+			std::size_t size = lazy.calculateMatching(graph);
+			lazyWork = lazy.requeueWork();
+			return size;
+		});
+
+		printf("Requeue work (adjacency entries): eager %lu, lazy %lu\n", eagerWork, lazyWork);
+	}
+
+	// Interleaved neighbor scans with prefetching. This only pays off if
+	// the vertex state does not fit into the cache.
+	{
+		printHeader("Interleaved scans (Graph)");
+
+		EdmondsCardinalityMatching edmond;
+		benchmark("1 scan", [&]() { return edmond.calculateMatching(graph); });
+
+		for(unsigned int scans : {4, 8, 16})
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "%u interleaved scans", scans);
+
+			EdmondsCardinalityMatching interleaved;
+			interleaved.setInterleave(scans);
+			benchmark(name, [&]() { return interleaved.calculateMatching(graph); });
+		}
+	}
+
+	// Sparsification pre-pass on dense graphs
+	if(DenseGraph::isDense(graph.numNodes(), graph.numEdges()))
+	{
+		DenseGraph dense;
+		dense.reset(graph.numNodes());
+		for(const Graph::Edge& e : graph.edges())
+			dense.addEdge(e.first, e.second);
+
+		printHeader("Sparsification (DenseGraph)");
+
+		DenseEdmondsMatching edmond;
+		benchmark("DenseGraph", [&]() { return edmond.calculateMatching(dense); });
+
+		for(unsigned int k : {2, 8})
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "sparsified, k = %u", k);
+
+			SparsifiedMatching sparsified;
+			sparsified.setEdgesPerVertex(k);
+			sparsified.setSeed(k);
+			benchmark(name, [&]() { return sparsified.calculateMatching(dense); });
+
+			printf("  %u rounds, %lu subgraph edges, %.2f%% of the adjacency entries examined\n",
+				sparsified.rounds(), sparsified.subgraphEdges(),
+				50.0 * sparsified.edgesTouched() / dense.numEdges()
+			);
+		}
+	}
+
+	// Loading and solving in sequence vs. overlapped ingestion
+	{
+		printHeader("Ingestion (load + solve)");
+
+		enum Mode { SEQUENTIAL, PIPELINED, ONLINE_GREEDY };
+		const char* names[] = {"sequential", "pipelined", "pipelined + online greedy"};
+		double firstSearch[3];
+
+		for(int mode = SEQUENTIAL; mode <= ONLINE_GREEDY; ++mode)
+		{
+			double best = 1e100;
+			benchmark(names[mode], [&]() {
+				auto start = std::chrono::steady_clock::now();
+
+				IngestionLoader loader(mode == ONLINE_GREEDY);
+				std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+				if(mode == SEQUENTIAL)
+					parseGraph(*stream, loader);
+				else
+					parseGraphPipelined(*stream, loader);
+
+				double load = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				EdmondsCardinalityMatching edmond;
+				std::size_t size;
+				if(mode == ONLINE_GREEDY)
+					size = edmond.calculateMatching(loader.graph, loader.greedy.mates());
+				else
+					size = edmond.calculateMatching(loader.graph);
+
+				best = std::min(best, 1000.0 * (load + edmond.initTime()));
+				return size;
+			});
+			firstSearch[mode] = best;
+		}
+
+		printf("Time to first search step [ms]: sequential %.2f, pipelined %.2f, online greedy %.2f\n",
+			firstSearch[SEQUENTIAL], firstSearch[PIPELINED], firstSearch[ONLINE_GREEDY]
+		);
+	}
+
+	// Memory footprint of the representations chosen by --max-memory
+	{
+		printHeader("Memory footprint (load + solve)");
+
+		MemoryUsage graphUsage;
+		benchmark("Graph", [&]() {
+			std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+			Graph loaded;
+			loaded.load(*stream);
+
+			EdmondsCardinalityMatching edmond;
+			std::size_t size = edmond.calculateMatching(loaded);
+
+			graphUsage = MemoryUsage();
+			loaded.memoryUsage(&graphUsage);
+			edmond.memoryUsage(&graphUsage);
+			return size;
+		});
+
+		MemoryUsage csrUsage;
+		benchmark("CSRGraphBuilder<uint32_t>", [&]() {
+			std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+			CSRLoader loader;
+			parseGraph(*stream, loader);
+			loader.builder.finish();
+
+			BasicEdmondsMatching<CSRGraph<uint32_t>> edmond;
+			std::size_t size = edmond.calculateMatching(loader.builder.graph());
+
+			csrUsage = MemoryUsage();
+			loader.builder.memoryUsage(&csrUsage);
+			edmond.memoryUsage(&csrUsage);
+			return size;
+		});
+
+		MemoryUsage graphEstimate;
+		Graph::estimateMemory(graph.numNodes(), graph.numEdges(), &graphEstimate);
+		EdmondsCardinalityMatching::estimateMemory(graph.numNodes(), &graphEstimate);
+
+		MemoryUsage csrEstimate;
+		CSRGraphBuilder<uint32_t>::estimateMemory(graph.numNodes(), graph.numEdges(), &csrEstimate);
+		EdmondsCardinalityMatching::estimateMemory(graph.numNodes(), &csrEstimate);
+
+		printf("Graph + solver: %s (estimate %s), CSR + solver: %s (estimate %s)\n",
+			memory::formatSize(graphUsage.total()).c_str(),
+			memory::formatSize(graphEstimate.total()).c_str(),
+			memory::formatSize(csrUsage.total()).c_str(),
+			memory::formatSize(csrEstimate.total()).c_str()
+		);
+	}
+
+	// Weighted matching on the same graph (weight 1 if the input has none)
+	{
+		WeightedGraph weightedGraph;
+		std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+		weightedGraph.load(*stream);
+		stream.reset();
+
+		printHeader("Weighted matching");
+
+		CSRGraph<uint64_t> view = weightedGraph.view();
+		BasicEdmondsMatching<CSRGraph<uint64_t>> edmond;
+		benchmark("cardinality (exact)", [&]() { return edmond.calculateMatching(view); });
+
+		unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+		WeightedGraph::Weight suitorWeight = 0.0;
+		WeightedGraph::Weight improvedWeight = 0.0;
+
+		WeightedMatching sequential;
+		sequential.setThreads(1);
+		benchmark("suitor, 1 thread", [&]() {
+			std::size_t size = sequential.calculateMatching(weightedGraph);
+			suitorWeight = sequential.weight();
+			return size;
+		});
+
+		if(numThreads > 1)
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "suitor, %u threads", numThreads);
+			WeightedMatching parallel;
+			parallel.setThreads(numThreads);
+			benchmark(name, [&]() { return parallel.calculateMatching(weightedGraph); });
+		}
+
+		WeightedMatching improved;
+		improved.setThreads(numThreads);
+		improved.setRounds(3);
+		benchmark("suitor + 3 rounds", [&]() {
+			std::size_t size = improved.calculateMatching(weightedGraph);
+			improvedWeight = improved.weight();
+			return size;
+		});
+
+		printf("Matching weight: suitor %.10g, suitor + 3 rounds %.10g\n", suitorWeight, improvedWeight);
+	}
+
+	// Memory policies. The policy only affects new allocations, so the
+	// graph needs to be reloaded for each variant.
+	printHeader("Memory policies (CSR arrays)");
+
+	struct Policy
+	{
+		const char* name;
+		memory::HugePages hugePages;
+		memory::Placement placement;
+	};
+	const Policy policies[] = {
+		{"default", memory::HUGEPAGES_NONE, memory::PLACEMENT_DEFAULT},
+		{"transparent huge pages", memory::HUGEPAGES_TRANSPARENT, memory::PLACEMENT_DEFAULT},
+		{"explicit huge pages", memory::HUGEPAGES_EXPLICIT, memory::PLACEMENT_DEFAULT},
+		{"NUMA interleave", memory::HUGEPAGES_NONE, memory::PLACEMENT_INTERLEAVE},
+		{"THP + NUMA interleave", memory::HUGEPAGES_TRANSPARENT, memory::PLACEMENT_INTERLEAVE},
+	};
+
+	for(const Policy& policy : policies)
+	{
+		memory::setHugePages(policy.hugePages);
+		memory::setPlacement(policy.placement);
+
+		// The adjacency lists of Graph are not covered by the policy
+		CSRLoader loader;
+		std::unique_ptr<std::istream> stream = CompressedInput::open(inputFile);
+		parseGraph(*stream, loader);
+		loader.builder.finish();
+		CSRGraph<uint32_t> policyGraph = loader.builder.graph();
+
+		BasicEdmondsMatching<CSRGraph<uint32_t>> edmond;
+		benchmark(policy.name, [&]() { return edmond.calculateMatching(policyGraph); });
+	}
+
+	// Compressed input: decompression pipelined with parsing vs.
+	// decompressing to a temporary file first. The size column shows the
+	// number of edges here.
+	if(CompressedInput::detect(inputFile) != CompressedInput::NONE)
+	{
+		memory::setHugePages(memory::HUGEPAGES_NONE);
+		memory::setPlacement(memory::PLACEMENT_DEFAULT);
+
+		printHeader("Compressed input (loadDIMAC)");
+
+		std::size_t bytes = 0;
+		double pipelined = benchmark("pipelined", [&]() {
+			CompressedInput input(inputFile);
+			Graph loaded;
+			loaded.loadDIMAC(input);
+			bytes = input.bytesRead();
+			return loaded.numEdges();
+		});
+
+		double sequential = benchmark("decompress, then parse", [&]() {
+			char path[] = "/tmp/edmonds-bench-XXXXXX";
+			int fd = mkstemp(path);
+			if(fd < 0)
+			{
+				perror("Could not create temporary file");
+				exit(1);
+			}
+			close(fd);
+
+			{
+				CompressedInput input(inputFile);
+				std::ofstream out(path);
+				out << input.rdbuf();
+			}
+
+			std::ifstream input(path);
+			Graph loaded;
+			loaded.loadDIMAC(input);
+			unlink(path);
+			return loaded.numEdges();
+		});
+
+		printf("%lu bytes uncompressed: pipelined %.1f MB/s, decompress then parse %.1f MB/s\n",
+			bytes, bytes / pipelined / 1e3, bytes / sequential / 1e3
+		);
+	}
+
+	// Blossom-heavy family (independent of the input graph)
+	{
+		printHeader("Blossom-heavy family (triangular lattices, 10% holes)");
+
+		for(unsigned int size : {200, 400, 800})
+		{
+			Graph lattice;
+			triangularLattice(&lattice, size, size, 0.1, size);
+
+			char name[64];
+			snprintf(name, sizeof(name), "%ux%u", size, size);
+
+			EdmondsCardinalityMatching edmond;
+			benchmark(name, [&]() { return edmond.calculateMatching(lattice); });
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Graph view on Boost.Graph adjacency lists
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef BOOST_GRAPH_H
+#define BOOST_GRAPH_H
+
+#include "graph.h"
+
+#include <boost/graph/adjacency_list.hpp>
+
+/**
+ * Read-only view on an undirected boost::adjacency_list, so that
+ * BasicEdmondsMatching can run on it without conversion. The vertex list
+ * has to be a random access container (vecS), so that vertex descriptors
+ * are the indices 0..n-1.
+ *
+ * BasicEdmondsMatching is not compiled for this view in edmonds.cpp, so
+ * users need to include edmonds_impl.h.
+ **/
+template<class BGraph>
+class BoostGraph
+{
+public:
+	typedef typename boost::graph_traits<BGraph>::adjacency_iterator AdjacencyIterator;
+
+	//! Range of adjacent nodes, usable in range-based for loops
+	class NeighborRange
+	{
+	public:
+		explicit NeighborRange(const std::pair<AdjacencyIterator, AdjacencyIterator>& range)
+		 : m_range(range)
+		{}
+
+		AdjacencyIterator begin() const
+		{ return m_range.first; }
+
+		AdjacencyIterator end() const
+		{ return m_range.second; }
+	private:
+		std::pair<AdjacencyIterator, AdjacencyIterator> m_range;
+	};
+
+	explicit BoostGraph(const BGraph& graph)
+	 : m_graph(&graph)
+	{}
+
+	//! Return number of nodes in the graph
+	NodeID numNodes() const
+	{ return boost::num_vertices(*m_graph); }
+
+	//! Return the adjacent nodes of @a v
+	NeighborRange neighbors(NodeID v) const
+	{ return NeighborRange(boost::adjacent_vertices(v, *m_graph)); }
+
+	//! Return the number of adjacent nodes of @a v
+	std::size_t degree(NodeID v) const
+	{ return boost::out_degree(v, *m_graph); }
+private:
+	const BGraph* m_graph;
+};
+
+#endif
@@ -0,0 +1,156 @@
+// Checkpoints of the solver state
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "checkpoint.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
+namespace checkpoint
+{
+
+namespace
+{
+	const char Magic[8] = {'E', 'D', 'M', 'C', 'K', 'P', '1', 0};
+
+	struct Header
+	{
+		char magic[8];
+		uint64_t numNodes;
+		uint64_t fingerprint;
+	};
+
+	bool writeFull(int fd, const void* data, std::size_t size)
+	{
+		const char* p = (const char*)data;
+		while(size != 0)
+		{
+			ssize_t ret = ::write(fd, p, size);
+			if(ret < 0 && errno == EINTR)
+				continue;
+			if(ret <= 0)
+				return false;
+
+			p += ret;
+			size -= ret;
+		}
+
+		return true;
+	}
+
+	bool readFull(int fd, void* data, std::size_t size)
+	{
+		char* p = (char*)data;
+		while(size != 0)
+		{
+			ssize_t ret = ::read(fd, p, size);
+			if(ret < 0 && errno == EINTR)
+				continue;
+			if(ret <= 0)
+				return false;
+
+			p += ret;
+			size -= ret;
+		}
+
+		return true;
+	}
+}
+
+bool write(const std::string& path, uint64_t fingerprint, const LargeVector<NodeID>& mates)
+{
+	std::string tmpPath = path + ".tmp";
+
+	int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+
+	Header header;
+	memcpy(header.magic, Magic, sizeof(Magic));
+	header.numNodes = mates.size();
+	header.fingerprint = fingerprint;
+
+	static_assert(sizeof(NodeID) == sizeof(uint64_t), "mates are stored as uint64_t");
+
+	// Make sure the data is on disk before the rename makes it visible
+	bool ok = writeFull(fd, &header, sizeof(header))
+		&& writeFull(fd, mates.data(), mates.size() * sizeof(NodeID))
+		&& fsync(fd) == 0;
+
+	int err = errno;
+	close(fd);
+
+	if(!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+	{
+		if(ok)
+			err = errno;
+		unlink(tmpPath.c_str());
+		errno = err;
+		return false;
+	}
+
+	// The rename is only durable once the directory entry is on disk
+	std::string::size_type slash = path.rfind('/');
+	std::string dir = (slash == std::string::npos) ? "." : path.substr(0, std::max<std::size_t>(slash, 1));
+
+	int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+	if(dirfd < 0)
+		return false;
+
+	ok = fsync(dirfd) == 0;
+	err = errno;
+	close(dirfd);
+	errno = err;
+
+	return ok;
+}
+
+void read(const std::string& path, NodeID numNodes, uint64_t fingerprint, LargeVector<NodeID>* mates)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw Graph::LoadError("Could not open checkpoint " + path);
+
+	Header header;
+	if(!readFull(fd, &header, sizeof(header)) || memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+	{
+		close(fd);
+		throw Graph::LoadError("Invalid checkpoint file " + path);
+	}
+
+	if(header.numNodes != numNodes || header.fingerprint != fingerprint)
+	{
+		close(fd);
+		throw Graph::LoadError("Checkpoint " + path + " belongs to a different graph");
+	}
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || std::size_t(st.st_size) != sizeof(Header) + numNodes * sizeof(NodeID))
+	{
+		close(fd);
+		throw Graph::LoadError("Checkpoint file " + path + " has the wrong size");
+	}
+
+	mates->resize(numNodes);
+	bool ok = readFull(fd, mates->data(), mates->size() * sizeof(NodeID));
+	close(fd);
+
+	if(!ok)
+		throw Graph::LoadError("Checkpoint file " + path + " is truncated");
+
+	// The matching has to be consistent
+	for(NodeID v = 0; v < mates->size(); ++v)
+	{
+		NodeID w = (*mates)[v];
+		if(w >= mates->size() || (*mates)[w] != v)
+			throw Graph::LoadError("Checkpoint " + path + " contains an invalid matching");
+	}
+}
+
+}
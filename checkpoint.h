@@ -0,0 +1,115 @@
+// Checkpoints of the solver state
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "graph.h"
+
+#include <stdint.h>
+
+#include <string>
+
+/**
+ * Resumable state of BasicEdmondsMatching, stored in a binary file
+ * (host byte order):
+ *
+ * @code
+ *   char     magic[8];       // "EDMCKP1\0"
+ *   uint64_t numNodes;
+ *   uint64_t fingerprint;    // see fingerprint()
+ *   uint64_t mates[numNodes];
+ * @endcode
+ *
+ * Only the matching is stored. The remaining state (forest, blossoms and
+ * the outer vertex queue) is rebuilt by the forest reset when the search
+ * is resumed, where the queue consists of exactly the exposed vertices.
+ **/
+namespace checkpoint
+{
+
+/**
+ * Fingerprint of the graph, which is used to detect checkpoints of a
+ * different graph. All adjacency entries (v,w) are hashed and summed up, so
+ * the result does not depend on the order of the adjacency lists (and thus
+ * on the graph representation).
+ **/
+template<class GraphT>
+uint64_t fingerprint(const GraphT& graph)
+{
+	// splitmix64 finalizer
+	auto mix = [](uint64_t x) {
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ull;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	};
+
+	uint64_t hash = mix(graph.numNodes());
+	for(NodeID v = 0; v < graph.numNodes(); ++v)
+	{
+		uint64_t hv = mix(v + 0x9e3779b97f4a7c15ull);
+		for(NodeID w : graph.neighbors(v))
+			hash += mix(hv ^ w);
+	}
+
+	return hash;
+}
+
+/**
+ * Check that each pair of @a mates (as read by read()) is an edge of
+ * @a graph.
+ *
+ * @throw Graph::LoadError if the matching does not belong to the graph
+ **/
+template<class GraphT>
+void validate(const GraphT& graph, const LargeVector<NodeID>& mates)
+{
+	if(mates.size() != graph.numNodes())
+		throw Graph::LoadError("Checkpoint belongs to a different graph");
+
+	for(NodeID v = 0; v < mates.size(); ++v)
+	{
+		if(mates[v] == v)
+			continue;
+
+		bool found = false;
+		for(NodeID w : graph.neighbors(v))
+		{
+			if(w == mates[v])
+			{
+				found = true;
+				break;
+			}
+		}
+
+		if(!found)
+			throw Graph::LoadError("Checkpoint belongs to a different graph");
+	}
+}
+
+/**
+ * Write @a mates to @a path. The file is written to a temporary file
+ * first and atomically renamed, so that @a path always contains a complete
+ * checkpoint. The file and the directory are synced to disk before
+ * returning.
+ *
+ * @return false on error (errno is set)
+ **/
+bool write(const std::string& path, uint64_t fingerprint, const LargeVector<NodeID>& mates);
+
+/**
+ * Read the checkpoint @a path of a graph with @a numNodes nodes into
+ * @a mates. The header is checked against @a numNodes and @a fingerprint
+ * (and the file size) before @a mates is allocated, so a foreign or
+ * corrupt file cannot force a large allocation.
+ *
+ * @throw Graph::LoadError if the file is invalid or belongs to a graph with
+ *   a different size or fingerprint
+ **/
+void read(const std::string& path, NodeID numNodes, uint64_t fingerprint, LargeVector<NodeID>* mates);
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+// Load generator for the matching server
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "server_protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static void usage()
+{
+	fprintf(stderr,
+		"Usage: edmonds-client [options] <socket> <graph file>\n"
+		"\n"
+		"Sends solve requests to a running 'edmonds --server' instance and\n"
+		"reports the request latencies.\n"
+		"\n"
+		"Options:\n"
+		"  --requests N     Number of requests per connection (default: 100)\n"
+		"  --connections N  Number of parallel connections (default: 1)\n"
+	);
+}
+
+/**
+ * Send @a numRequests requests over a new connection and store the
+ * latencies in @a latencies (in microseconds).
+ *
+ * @return false on error
+ **/
+static bool runConnection(const std::string& socket, const std::string& graph,
+	unsigned int numRequests, std::vector<double>* latencies, uint64_t* matchingSize)
+{
+	int fd = protocol::connect(socket);
+	if(fd < 0)
+	{
+		perror("Could not connect to server");
+		return false;
+	}
+
+	protocol::RequestHeader request;
+	request.magic = protocol::MAGIC;
+	request.type = protocol::REQUEST_SOLVE;
+	request.pathLength = graph.size();
+
+	std::vector<char> buffer(sizeof(request) + graph.size());
+	memcpy(buffer.data(), &request, sizeof(request));
+	memcpy(buffer.data() + sizeof(request), graph.data(), graph.size());
+
+	std::vector<uint32_t> mates;
+	for(unsigned int i = 0; i < numRequests; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		protocol::ReplyHeader reply;
+		if(!protocol::writeFull(fd, buffer.data(), buffer.size())
+			|| !protocol::readFull(fd, &reply, sizeof(reply)))
+		{
+			fprintf(stderr, "Connection to server lost\n");
+			close(fd);
+			return false;
+		}
+
+		if(reply.magic != protocol::MAGIC || reply.status != protocol::STATUS_OK)
+		{
+			fprintf(stderr, "Server returned error status %u\n", reply.status);
+			close(fd);
+			return false;
+		}
+
+		mates.resize(reply.numNodes);
+		if(!protocol::readFull(fd, mates.data(), mates.size() * sizeof(uint32_t)))
+		{
+			fprintf(stderr, "Connection to server lost\n");
+			close(fd);
+			return false;
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		latencies->push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		*matchingSize = reply.matchingSize;
+	}
+
+	close(fd);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int numRequests = 100;
+	unsigned int numConnections = 1;
+	std::vector<const char*> args;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(!strcmp(argv[i], "--requests") && i+1 < argc)
+			numRequests = strtoul(argv[++i], 0, 10);
+		else if(!strcmp(argv[i], "--connections") && i+1 < argc)
+			numConnections = std::max(1ul, strtoul(argv[++i], 0, 10));
+		else if(argv[i][0] == '-')
+		{
+			usage();
+			return 1;
+		}
+		else
+			args.push_back(argv[i]);
+	}
+
+	if(args.size() != 2)
+	{
+		usage();
+		return 1;
+	}
+
+	// The server resolves the path, so make it absolute
+	std::string graph = args[1];
+	if(graph[0] != '/')
+	{
+		char* cwd = getcwd(0, 0);
+		graph = std::string(cwd) + "/" + graph;
+		free(cwd);
+	}
+
+	std::vector<std::vector<double>> latencies(numConnections);
+	std::vector<uint64_t> sizes(numConnections, 0);
+	std::vector<char> success(numConnections, 0);
+	std::vector<std::thread> threads;
+
+	auto start = std::chrono::steady_clock::now();
+	for(unsigned int i = 0; i < numConnections; ++i)
+	{
+		threads.emplace_back([&, i]() {
+			success[i] = runConnection(args[0], graph, numRequests, &latencies[i], &sizes[i]);
+		});
+	}
+	for(std::thread& thread : threads)
+		thread.join();
+	auto end = std::chrono::steady_clock::now();
+
+	std::vector<double> all;
+	for(unsigned int i = 0; i < numConnections; ++i)
+	{
+		if(!success[i])
+			return 1;
+		all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+	}
+
+	if(all.empty())
+		return 0;
+
+	std::sort(all.begin(), all.end());
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("Matching size: %lu\n", sizes[0]);
+	printf("Requests:      %lu in %.3f s (%.1f req/s)\n", all.size(), seconds, all.size() / seconds);
+	printf("Latency p50:   %.1f us\n", all[all.size() / 2]);
+	printf("Latency p99:   %.1f us\n", all[std::min(all.size() - 1, all.size() * 99 / 100)]);
+	printf("Latency max:   %.1f us\n", all.back());
+
+	return 0;
+}
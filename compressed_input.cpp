@@ -0,0 +1,396 @@
+// Transparent decompression of gzip/zstd input
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "compressed_input.h"
+#include "graph.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Ring of NumSlots buffers of SlotSize bytes each. Large slots keep the
+// synchronization overhead small, few slots bound the memory usage.
+static const std::size_t NumSlots = 4;
+static const std::size_t SlotSize = 1 << 20;
+
+////////////////////////////////////////////////////////////////////////////////
+// DECODERS
+
+namespace
+{
+	class Decoder
+	{
+	public:
+		virtual ~Decoder() {}
+
+		/**
+		 * Decompress up to @a size bytes to @a dest.
+		 *
+		 * @return Number of bytes written, 0 at the end of the input
+		 * @throw Graph::LoadError on error
+		 **/
+		virtual std::size_t read(char* dest, std::size_t size) = 0;
+	};
+
+#ifdef HAVE_ZLIB
+	class GzipDecoder : public Decoder
+	{
+	public:
+		explicit GzipDecoder(const char* path)
+		{
+			m_file = gzopen(path, "rb");
+			if(!m_file)
+				throw Graph::LoadError(std::string("Could not open ") + path);
+
+			gzbuffer(m_file, 1 << 17);
+		}
+
+		~GzipDecoder()
+		{
+			gzclose(m_file);
+		}
+
+		std::size_t read(char* dest, std::size_t size) override
+		{
+			int ret = gzread(m_file, dest, size);
+
+			// gzread() also returns 0 on a truncated stream, which is only
+			// reported through gzerror() (Z_BUF_ERROR)
+			if(ret <= 0)
+			{
+				int err = Z_OK;
+				const char* msg = gzerror(m_file, &err);
+				if(ret < 0 || err != Z_OK)
+					throw Graph::LoadError(std::string("gzip error: ") + msg);
+			}
+
+			return ret;
+		}
+	private:
+		gzFile m_file;
+	};
+#endif
+
+#ifdef HAVE_ZSTD
+	class ZstdDecoder : public Decoder
+	{
+	public:
+		explicit ZstdDecoder(const char* path)
+		 : m_input(ZSTD_DStreamInSize())
+		 , m_pos(0)
+		 , m_size(0)
+		 , m_eof(false)
+		 , m_lastRet(0)
+		{
+			m_file = fopen(path, "rb");
+			if(!m_file)
+				throw Graph::LoadError(std::string("Could not open ") + path);
+
+			m_stream = ZSTD_createDStream();
+			ZSTD_initDStream(m_stream);
+		}
+
+		~ZstdDecoder()
+		{
+			ZSTD_freeDStream(m_stream);
+			fclose(m_file);
+		}
+
+		std::size_t read(char* dest, std::size_t size) override
+		{
+			ZSTD_outBuffer out = {dest, size, 0};
+
+			while(out.pos < out.size)
+			{
+				if(m_pos == m_size && !m_eof)
+				{
+					m_size = fread(m_input.data(), 1, m_input.size(), m_file);
+					m_pos = 0;
+
+					if(m_size == 0)
+					{
+						if(ferror(m_file))
+							throw Graph::LoadError("Could not read zstd input");
+						m_eof = true;
+					}
+				}
+
+				// At the end of the input, the decoder may still have
+				// buffered output, so we keep calling it until it makes no
+				// more progress.
+				std::size_t before = out.pos;
+				ZSTD_inBuffer in = {m_input.data(), m_size, m_pos};
+				std::size_t ret = ZSTD_decompressStream(m_stream, &out, &in);
+				if(ZSTD_isError(ret))
+					throw Graph::LoadError(std::string("zstd error: ") + ZSTD_getErrorName(ret));
+				if(m_eof && out.pos == before)
+				{
+					// A return value of 0 from the last call which made
+					// progress means the last frame is complete
+					if(m_lastRet != 0)
+						throw Graph::LoadError("zstd input is truncated");
+					break;
+				}
+
+				m_pos = in.pos;
+				m_lastRet = ret;
+			}
+
+			return out.pos;
+		}
+	private:
+		FILE* m_file;
+		ZSTD_DStream* m_stream;
+		std::vector<char> m_input;
+		std::size_t m_pos;
+		std::size_t m_size;
+
+		//! Has the end of the file been reached?
+		bool m_eof;
+
+		//! Last result of ZSTD_decompressStream() which made progress
+		std::size_t m_lastRet;
+	};
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RING BUFFER
+
+/**
+ * std::streambuf which hands out the slots filled by the producer thread.
+ * The slot currently read by the consumer is released to the producer on
+ * the next underflow().
+ **/
+class DecompressingBuffer : public std::streambuf
+{
+public:
+	explicit DecompressingBuffer(std::unique_ptr<Decoder>&& decoder)
+	 : m_decoder(std::move(decoder))
+	 , m_slots(NumSlots, std::vector<char>(SlotSize))
+	 , m_sizes(NumSlots, 0)
+	 , m_head(0)
+	 , m_filled(0)
+	 , m_done(false)
+	 , m_stop(false)
+	 , m_holding(false)
+	 , m_consumed(0)
+	{
+		m_producer = std::thread(&DecompressingBuffer::produce, this);
+	}
+
+	~DecompressingBuffer()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_notFull.notify_one();
+		m_producer.join();
+	}
+
+	std::size_t bytesRead() const
+	{ return m_consumed - (egptr() - gptr()); }
+protected:
+	int_type underflow() override
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// Give the slot we just finished back to the producer
+		if(m_holding)
+		{
+			m_head = (m_head + 1) % NumSlots;
+			m_filled--;
+			m_holding = false;
+			m_notFull.notify_one();
+		}
+
+		m_notEmpty.wait(lock, [&]() { return m_filled != 0 || m_done; });
+
+		if(m_filled == 0)
+		{
+			setg(0, 0, 0);
+
+			if(!m_error.empty())
+				throw Graph::LoadError(m_error);
+
+			return traits_type::eof();
+		}
+
+		char* data = m_slots[m_head].data();
+		setg(data, data, data + m_sizes[m_head]);
+		m_consumed += m_sizes[m_head];
+		m_holding = true;
+
+		return traits_type::to_int_type(*data);
+	}
+private:
+	void produce()
+	{
+		std::size_t tail = 0;
+
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_notFull.wait(lock, [&]() { return m_filled != NumSlots || m_stop; });
+				if(m_stop)
+					return;
+			}
+
+			// The slot at tail is not visible to the consumer, so we can
+			// fill it without holding the lock.
+			std::size_t size = 0;
+			std::string error;
+			try
+			{
+				size = m_decoder->read(m_slots[tail].data(), SlotSize);
+			}
+			catch(Graph::LoadError& e)
+			{
+				error = e.what();
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if(size == 0)
+			{
+				m_done = true;
+				m_error = error;
+				m_notEmpty.notify_one();
+				return;
+			}
+
+			m_sizes[tail] = size;
+			m_filled++;
+			tail = (tail + 1) % NumSlots;
+			m_notEmpty.notify_one();
+		}
+	}
+
+	std::unique_ptr<Decoder> m_decoder;
+
+	std::vector<std::vector<char>> m_slots;
+	std::vector<std::size_t> m_sizes;
+
+	//! First filled slot
+	std::size_t m_head;
+
+	//! Number of filled slots (including the one held by the consumer)
+	std::size_t m_filled;
+
+	bool m_done;
+	bool m_stop;
+	std::string m_error;
+
+	//! Does the consumer currently read from slot m_head?
+	bool m_holding;
+	std::size_t m_consumed;
+
+	std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+	std::thread m_producer;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// STREAM
+
+CompressedInput::CompressedInput(const char* path)
+ : std::istream(0)
+{
+	std::unique_ptr<Decoder> decoder;
+
+	switch(detect(path))
+	{
+#ifdef HAVE_ZLIB
+		case GZIP:
+			decoder.reset(new GzipDecoder(path));
+			break;
+#endif
+#ifdef HAVE_ZSTD
+		case ZSTD:
+			decoder.reset(new ZstdDecoder(path));
+			break;
+#endif
+		default:
+			throw Graph::LoadError(std::string("Unsupported compression format in ") + path);
+	}
+
+	m_buffer.reset(new DecompressingBuffer(std::move(decoder)));
+	rdbuf(m_buffer.get());
+
+	// Let decompression errors from the buffer propagate to the caller
+	exceptions(std::ios::badbit);
+}
+
+CompressedInput::~CompressedInput()
+{
+}
+
+std::size_t CompressedInput::bytesRead() const
+{
+	return m_buffer->bytesRead();
+}
+
+CompressedInput::Format CompressedInput::detect(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if(!file)
+		return NONE;
+
+	unsigned char magic[4];
+	std::size_t size = fread(magic, 1, sizeof(magic), file);
+	fclose(file);
+
+	if(size >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+		return GZIP;
+
+	if(size == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+		return ZSTD;
+
+	return NONE;
+}
+
+bool CompressedInput::isSupported(Format format)
+{
+	switch(format)
+	{
+		case NONE:
+			return true;
+		case GZIP:
+#ifdef HAVE_ZLIB
+			return true;
+#else
+			return false;
+#endif
+		case ZSTD:
+#ifdef HAVE_ZSTD
+			return true;
+#else
+			return false;
+#endif
+	}
+
+	return false;
+}
+
+std::unique_ptr<std::istream> CompressedInput::open(const char* path)
+{
+	if(detect(path) != NONE)
+		return std::unique_ptr<std::istream>(new CompressedInput(path));
+
+	return std::unique_ptr<std::istream>(new std::ifstream(path));
+}
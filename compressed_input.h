@@ -0,0 +1,65 @@
+// Transparent decompression of gzip/zstd input
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+
+class DecompressingBuffer;
+
+/**
+ * Input stream which decompresses a gzip or zstd compressed file.
+ *
+ * Decompression runs in a producer thread, which fills a bounded ring of
+ * buffers while the consumer (e.g. parseDIMAC()) parses the previous ones.
+ * This way, decompression and parsing overlap and no temporary file is
+ * needed.
+ *
+ * Decompression errors are reported by throwing Graph::LoadError from the
+ * stream operations.
+ **/
+class CompressedInput : public std::istream
+{
+public:
+	enum Format
+	{
+		NONE,
+		GZIP,
+		ZSTD
+	};
+
+	/**
+	 * Open compressed file @a path.
+	 *
+	 * @throw Graph::LoadError if the file cannot be opened or the format
+	 *   is not supported by this build
+	 **/
+	explicit CompressedInput(const char* path);
+	~CompressedInput();
+
+	//! Number of decompressed bytes consumed so far
+	std::size_t bytesRead() const;
+
+	//! Detect the compression format of file @a path by its magic number
+	static Format detect(const char* path);
+
+	//! Was support for @a format compiled in?
+	static bool isSupported(Format format);
+
+	/**
+	 * Open @a path for reading, decompressing it on the fly if it is
+	 * compressed. If an uncompressed file cannot be opened, the returned
+	 * stream is in failed state (errno is set).
+	 *
+	 * @throw Graph::LoadError if a compressed file cannot be opened or its
+	 *   format is not supported by this build
+	 **/
+	static std::unique_ptr<std::istream> open(const char* path);
+private:
+	std::unique_ptr<DecompressingBuffer> m_buffer;
+};
+
+#endif
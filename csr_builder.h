@@ -0,0 +1,135 @@
+// Compact CSR graph built from a stream of edges
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef CSR_BUILDER_H
+#define CSR_BUILDER_H
+
+#include "graph.h"
+#include "csr_graph.h"
+#include "memory_usage.h"
+
+#include <limits>
+#include <utility>
+
+/**
+ * Owns the arrays of a CSRGraph and builds them from edges arriving in
+ * arbitrary order (e.g. from parseDIMAC()).
+ *
+ * In contrast to Graph, there is no per-node vector and no edge list is
+ * kept after loading: the edges are buffered as pairs of @a Index, sorted
+ * into the neighbor array by finish() and the buffer is released. With
+ * 32-bit indices, the graph needs 4n + 8m bytes after loading instead of
+ * roughly 24n + 40m bytes for Graph.
+ **/
+template<class Index>
+class CSRGraphBuilder
+{
+public:
+	CSRGraphBuilder()
+	 : m_nodeCount(0)
+	 , m_edgeBufferPeak(0)
+	{}
+
+	/**
+	 * Start a graph with @a numNodes nodes. @a numEdges (e.g. from the
+	 * DIMAC header) is reserved in the edge buffer.
+	 *
+	 * @throw Graph::LoadError if @a numNodes does not fit into Index
+	 **/
+	void reset(NodeID numNodes, std::size_t numEdges)
+	{
+		if(numNodes > std::numeric_limits<Index>::max())
+			throw Graph::LoadError("Too many nodes for the CSR index type");
+
+		m_nodeCount = numNodes;
+		m_offsets.clear();
+		m_neighbors.clear();
+		m_edges.clear();
+		m_edges.reserve(numEdges);
+	}
+
+	//! Add an edge connecting v and w
+	void addEdge(NodeID v, NodeID w)
+	{ m_edges.emplace_back(Index(v), Index(w)); }
+
+	/**
+	 * Build the CSR arrays from the buffered edges and release the buffer.
+	 *
+	 * @throw Graph::LoadError if the number of adjacency entries does not
+	 *   fit into Index
+	 **/
+	void finish()
+	{
+		if(m_edges.size() > std::numeric_limits<Index>::max() / 2)
+			throw Graph::LoadError("Too many edges for the CSR index type");
+
+		m_offsets.assign(m_nodeCount + 1, 0);
+		for(const Edge& e : m_edges)
+		{
+			m_offsets[e.first + 1]++;
+			m_offsets[e.second + 1]++;
+		}
+		for(NodeID v = 0; v < m_nodeCount; ++v)
+			m_offsets[v + 1] += m_offsets[v];
+
+		// Insert the neighbors in input order, as Graph does. m_offsets[v]
+		// is used as insertion position and restored afterwards.
+		m_neighbors.resize(2 * m_edges.size());
+		for(const Edge& e : m_edges)
+		{
+			m_neighbors[m_offsets[e.first]++] = e.second;
+			m_neighbors[m_offsets[e.second]++] = e.first;
+		}
+		for(NodeID v = m_nodeCount; v > 0; --v)
+			m_offsets[v] = m_offsets[v - 1];
+		m_offsets[0] = 0;
+
+		m_edgeBufferPeak = memory::bytes(m_edges);
+		LargeVector<Edge>().swap(m_edges);
+	}
+
+	//! View on the graph, valid after finish()
+	CSRGraph<Index> graph() const
+	{ return CSRGraph<Index>(m_nodeCount, m_offsets.data(), m_neighbors.data()); }
+
+	NodeID numNodes() const
+	{ return m_nodeCount; }
+
+	//! Can a graph with @a numNodes nodes and @a numEdges edges be stored?
+	static bool fits(NodeID numNodes, std::size_t numEdges)
+	{
+		return numNodes <= std::numeric_limits<Index>::max()
+			&& numEdges <= std::numeric_limits<Index>::max() / 2;
+	}
+
+	/**
+	 * Add the expected size of the CSR arrays to @a usage.
+	 *
+	 * @return Size of the edge buffer, which is only needed while loading
+	 **/
+	static std::size_t estimateMemory(NodeID numNodes, std::size_t numEdges, MemoryUsage* usage)
+	{
+		usage->add("CSR offsets", (numNodes + 1) * sizeof(Index));
+		usage->add("CSR neighbors", 2 * numEdges * sizeof(Index));
+		return numEdges * sizeof(Edge);
+	}
+
+	//! Add the memory used by the graph to @a usage
+	void memoryUsage(MemoryUsage* usage) const
+	{
+		usage->add("CSR offsets", memory::bytes(m_offsets));
+		usage->add("CSR neighbors", memory::bytes(m_neighbors));
+		usage->add("edge buffer (loading only)", m_edgeBufferPeak);
+	}
+private:
+	typedef std::pair<Index, Index> Edge;
+
+	NodeID m_nodeCount;
+	LargeVector<Index> m_offsets;
+	LargeVector<Index> m_neighbors;
+
+	LargeVector<Edge> m_edges;
+	std::size_t m_edgeBufferPeak;
+};
+
+#endif
@@ -0,0 +1,113 @@
+// Undirected graph in compressed sparse row format
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph.h"
+
+/**
+ * Read-only view on a graph in compressed sparse row (CSR) format.
+ *
+ * The neighbors of node v are neighbors[offsets[v]] ...
+ * neighbors[offsets[v+1]-1]. Each undirected edge has to be present in the
+ * lists of both end nodes. The arrays are owned by the caller and are not
+ * copied, so they need to outlive the view.
+ *
+ * @a Index is the integer type of the arrays (e.g. uint32_t or uint64_t).
+ **/
+template<class Index>
+class CSRGraph
+{
+public:
+	//! Range of adjacent nodes, usable in range-based for loops
+	class NeighborRange
+	{
+	public:
+		NeighborRange(const Index* begin, const Index* end)
+		 : m_begin(begin), m_end(end)
+		{}
+
+		const Index* begin() const
+		{ return m_begin; }
+
+		const Index* end() const
+		{ return m_end; }
+	private:
+		const Index* m_begin;
+		const Index* m_end;
+	};
+
+	CSRGraph(NodeID numNodes, const Index* offsets, const Index* neighbors)
+	 : m_nodeCount(numNodes)
+	 , m_offsets(offsets)
+	 , m_neighbors(neighbors)
+	{}
+
+	//! Return number of nodes in the graph
+	NodeID numNodes() const
+	{ return m_nodeCount; }
+
+	//! Return number of edges in the graph
+	std::size_t numEdges() const
+	{ return m_offsets[m_nodeCount] / 2; }
+
+	//! Return the adjacent nodes of @a v
+	NeighborRange neighbors(NodeID v) const
+	{ return NeighborRange(m_neighbors + m_offsets[v], m_neighbors + m_offsets[v+1]); }
+
+	//! Return the number of adjacent nodes of @a v
+	std::size_t degree(NodeID v) const
+	{ return m_offsets[v+1] - m_offsets[v]; }
+
+	/**
+	 * Check that the offsets start at 0, are monotonic and end at
+	 * @a numEntries, the size of the neighbor array (O(n)). The neighbor
+	 * array is not accessed, so this is safe to call before isValid() on
+	 * untrusted data.
+	 **/
+	bool hasValidOffsets(std::size_t numEntries) const
+	{
+		if(m_offsets[0] != 0)
+			return false;
+
+		for(NodeID v = 0; v < m_nodeCount; ++v)
+		{
+			if(m_offsets[v+1] < m_offsets[v])
+				return false;
+		}
+
+		return m_offsets[m_nodeCount] == numEntries;
+	}
+
+	/**
+	 * Check that the offsets are monotonic and that all neighbor IDs are
+	 * valid (O(n+m)). Symmetry is not checked. The neighbor array must
+	 * hold at least offsets[n] entries (see hasValidOffsets()).
+	 **/
+	bool isValid() const
+	{
+		if(m_offsets[0] != 0)
+			return false;
+
+		for(NodeID v = 0; v < m_nodeCount; ++v)
+		{
+			if(m_offsets[v+1] < m_offsets[v])
+				return false;
+		}
+
+		for(std::size_t i = 0; i < m_offsets[m_nodeCount]; ++i)
+		{
+			if(m_neighbors[i] >= m_nodeCount)
+				return false;
+		}
+
+		return true;
+	}
+private:
+	NodeID m_nodeCount;
+	const Index* m_offsets;
+	const Index* m_neighbors;
+};
+
+#endif
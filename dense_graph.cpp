@@ -0,0 +1,120 @@
+// Undirected graph stored as adjacency matrix
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "dense_graph.h"
+#include "dimac.h"
+
+#include <assert.h>
+
+DenseGraph::NeighborIterator::NeighborIterator(const Word* row, std::size_t word, std::size_t numWords)
+ : m_row(row)
+ , m_word(word)
+ , m_numWords(numWords)
+ , m_bits(word < numWords ? row[word] : 0)
+{
+	skipEmpty();
+}
+
+void DenseGraph::NeighborIterator::skipEmpty()
+{
+	while(!m_bits && m_word < m_numWords)
+	{
+		m_word++;
+		if(m_word < m_numWords)
+			m_bits = m_row[m_word];
+	}
+}
+
+DenseGraph::NeighborIterator& DenseGraph::NeighborIterator::operator++()
+{
+	// Clear lowest set bit
+	m_bits &= m_bits - 1;
+	skipEmpty();
+	return *this;
+}
+
+DenseGraph::DenseGraph()
+ : m_nodeCount(0)
+ , m_edgeCount(0)
+ , m_numWords(0)
+{
+}
+
+void DenseGraph::reset(NodeID numNodes)
+{
+	m_nodeCount = numNodes;
+	m_edgeCount = 0;
+	m_numWords = (numNodes + WordBits - 1) / WordBits;
+
+	m_matrix.clear();
+	m_matrix.resize(m_nodeCount * m_numWords, 0);
+
+	m_degree.clear();
+	m_degree.resize(m_nodeCount, 0);
+}
+
+void DenseGraph::addEdge(NodeID v, NodeID w)
+{
+	assert(v < m_nodeCount);
+	assert(w < m_nodeCount);
+
+	if(adjacent(v, w))
+		return;
+
+	m_matrix[v * m_numWords + w / WordBits] |= Word(1) << (w % WordBits);
+	m_matrix[w * m_numWords + v / WordBits] |= Word(1) << (v % WordBits);
+
+	m_degree[v]++;
+	if(v != w)
+		m_degree[w]++;
+
+	m_edgeCount++;
+}
+
+bool DenseGraph::isDense(NodeID numNodes, std::size_t numEdges)
+{
+	if(numNodes < 2)
+		return false;
+
+	double maxEdges = 0.5 * numNodes * (numNodes - 1);
+	return numEdges > 0.1 * maxEdges;
+}
+
+void DenseGraph::memoryUsage(MemoryUsage* usage) const
+{
+	usage->add("adjacency matrix", memory::bytes(m_matrix));
+	usage->add("degrees", memory::bytes(m_degree));
+}
+
+void DenseGraph::estimateMemory(NodeID numNodes, MemoryUsage* usage)
+{
+	std::size_t numWords = (numNodes + WordBits - 1) / WordBits;
+	usage->add("adjacency matrix", numNodes * numWords * sizeof(Word));
+	usage->add("degrees", numNodes * sizeof(std::size_t));
+}
+
+namespace
+{
+	//! parseDIMAC() handler which fills a DenseGraph
+	class DenseGraphBuilder
+	{
+	public:
+		explicit DenseGraphBuilder(DenseGraph* graph)
+		 : m_graph(graph)
+		{}
+
+		void header(NodeID numNodes, std::size_t)
+		{ m_graph->reset(numNodes); }
+
+		void edge(NodeID v, NodeID w)
+		{ m_graph->addEdge(v, w); }
+	private:
+		DenseGraph* m_graph;
+	};
+}
+
+void DenseGraph::loadDIMAC(std::istream& stream)
+{
+	DenseGraphBuilder builder(this);
+	parseDIMAC(stream, builder);
+}
@@ -0,0 +1,128 @@
+// Undirected graph stored as adjacency matrix
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef DENSE_GRAPH_H
+#define DENSE_GRAPH_H
+
+#include "graph.h"
+
+#include <stdint.h>
+
+/**
+ * Undirected graph with one adjacency bitset row per node. This needs
+ * n^2/8 bytes, which is smaller than adjacency lists for dense graphs,
+ * and allows to scan 64 neighbors at once.
+ *
+ * Parallel edges are merged.
+ **/
+class DenseGraph
+{
+public:
+	typedef uint64_t Word;
+	enum { WordBits = 64 };
+
+	/**
+	 * Iterates over the set bits of a bitset row (= adjacent nodes).
+	 **/
+	class NeighborIterator
+	{
+	public:
+		NeighborIterator(const Word* row, std::size_t word, std::size_t numWords);
+
+		NodeID operator*() const
+		{ return m_word * WordBits + __builtin_ctzll(m_bits); }
+
+		NeighborIterator& operator++();
+
+		bool operator!=(const NeighborIterator& other) const
+		{ return m_word != other.m_word || m_bits != other.m_bits; }
+	private:
+		void skipEmpty();
+
+		const Word* m_row;
+		std::size_t m_word;
+		std::size_t m_numWords;
+		Word m_bits; //!< remaining bits in the current word
+	};
+
+	//! Range of adjacent nodes, usable in range-based for loops
+	class NeighborRange
+	{
+	public:
+		NeighborRange(const Word* row, std::size_t numWords)
+		 : m_row(row), m_numWords(numWords)
+		{}
+
+		NeighborIterator begin() const
+		{ return NeighborIterator(m_row, 0, m_numWords); }
+
+		NeighborIterator end() const
+		{ return NeighborIterator(m_row, m_numWords, m_numWords); }
+	private:
+		const Word* m_row;
+		std::size_t m_numWords;
+	};
+
+	//! Thrown on error inside loadDIMAC()
+	typedef Graph::LoadError LoadError;
+
+	DenseGraph();
+
+	//! Reset the graph structure and create @a numNodes unconnected nodes
+	void reset(NodeID numNodes);
+
+	//! Add an edge connecting v and w
+	void addEdge(NodeID v, NodeID w);
+
+	//! Return number of nodes in the graph
+	NodeID numNodes() const
+	{ return m_nodeCount; }
+
+	//! Return number of (distinct) edges in the graph
+	std::size_t numEdges() const
+	{ return m_edgeCount; }
+
+	//! Number of words in each bitset row
+	std::size_t numWords() const
+	{ return m_numWords; }
+
+	//! Adjacency bitset row of node @a v
+	const Word* row(NodeID v) const
+	{ return &m_matrix[v * m_numWords]; }
+
+	//! Return the adjacent nodes of @a v
+	NeighborRange neighbors(NodeID v) const
+	{ return NeighborRange(row(v), m_numWords); }
+
+	//! Return the number of adjacent nodes of @a v (O(1))
+	std::size_t degree(NodeID v) const
+	{ return m_degree[v]; }
+
+	//! Are @a v and @a w adjacent?
+	bool adjacent(NodeID v, NodeID w) const
+	{ return (row(v)[w / WordBits] >> (w % WordBits)) & 1; }
+
+	//! Load a DIMAC graph from stream @a stream
+	void loadDIMAC(std::istream& stream);
+
+	/**
+	 * Decide whether a graph with @a numNodes nodes and @a numEdges edges
+	 * should be stored as DenseGraph (edge density above 10%).
+	 **/
+	static bool isDense(NodeID numNodes, std::size_t numEdges);
+
+	//! Add the memory used by the graph to @a usage
+	void memoryUsage(MemoryUsage* usage) const;
+
+	//! Add the memory needed for a graph with @a numNodes nodes to @a usage
+	static void estimateMemory(NodeID numNodes, MemoryUsage* usage);
+private:
+	NodeID m_nodeCount;
+	std::size_t m_edgeCount;
+	std::size_t m_numWords;
+
+	LargeVector<Word> m_matrix;
+	LargeVector<std::size_t> m_degree;
+};
+
+#endif
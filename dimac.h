@@ -0,0 +1,128 @@
+// DIMAC graph format parser
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef DIMAC_H
+#define DIMAC_H
+
+#include "graph.h"
+#include "scanner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+
+/**
+ * Parse a DIMAC graph from stream @a stream.
+ *
+ * This is the parser behind Graph::loadDIMAC(). It does not store the graph
+ * itself, but reports its contents to @a handler, which needs to provide
+ * the following methods:
+ *
+ * @code
+ *   void header(NodeID numNodes, std::size_t numEdges); // "p edge" line
+ *   void edge(NodeID v, NodeID w);                      // "e" line, 0-based
+ * @endcode
+ *
+ * Edge lines may carry a weight ("e v w weight"). Handlers which provide
+ * an additional method
+ *
+ * @code
+ *   void edge(NodeID v, NodeID w, double weight);       // default weight 1
+ * @endcode
+ *
+ * receive it, other handlers ignore it.
+ *
+ * @throw Graph::LoadError on malformed input
+ **/
+namespace dimac_detail
+{
+	// Report the edge with weight if the handler supports it
+	template<class Handler>
+	auto reportEdge(Handler& handler, NodeID v, NodeID w, double weight, int)
+		-> decltype(handler.edge(v, w, weight), void())
+	{ handler.edge(v, w, weight); }
+
+	template<class Handler>
+	void reportEdge(Handler& handler, NodeID v, NodeID w, double, long)
+	{ handler.edge(v, w); }
+}
+
+template<class Handler>
+void parseDIMAC(std::istream& stream, Handler& handler)
+{
+	bool initialized = false;
+	NodeID numNodes = 0;
+
+	std::string line;
+	while(!stream.eof())
+	{
+		std::getline(stream, line);
+
+		if(line.length() == 0 || line[0] == '\n')
+			continue;
+
+		if(line.compare(0, 7, "p edge ") == 0)
+		{
+			if(initialized)
+				throw Graph::LoadError("Found more than one DIMAC header (p ...)");
+
+			unsigned int n, m;
+			if(sscanf(line.c_str(), "p edge %u %u", &n, &m) != 2)
+				throw Graph::LoadError("Could not parse DIMAC header");
+
+			numNodes = n;
+			handler.header(n, m);
+			initialized = true;
+		}
+		else if(line[0] == 'e' && line[1] == ' ')
+		{
+			uint64_t v, w;
+
+			// Format: e v w
+			const char* p = line.data() + 2;
+			const char* end = line.data() + line.size();
+
+			if(!scanner::parseUInt(p, end, &v) || p == end || !scanner::isBlank(*p))
+				throw Graph::LoadError("Invalid edge specification");
+
+			p = scanner::skipBlanks(p, end);
+
+			if(!scanner::parseUInt(p, end, &w))
+				throw Graph::LoadError("Invalid edge specification");
+
+			// Optional weight
+			double weight = 1.0;
+			p = scanner::skipBlanks(p, end);
+			if(p != end)
+			{
+				char* endptr = 0;
+				weight = strtod(p, &endptr);
+				if(endptr == p || !scanner::atLineEnd(endptr, end))
+					throw Graph::LoadError("Invalid edge specification");
+			}
+
+			// Sanity check
+			if(v == 0 || w == 0)
+				throw Graph::LoadError("Zero node indices in edge spec");
+
+			// DIMAC is 1-based, we are 0-based
+			v -= 1;
+			w -= 1;
+
+			if(v >= numNodes || w >= numNodes)
+				throw Graph::LoadError("Node indices out of bounds in edge spec");
+
+			dimac_detail::reportEdge(handler, v, w, weight, 0);
+		}
+		else if(line[0] == 'c')
+		{
+		}
+		else
+		{
+			fprintf(stderr, "Warning: Unknown DIMAC line: '%s'\n", line.c_str());
+		}
+	}
+}
+
+#endif
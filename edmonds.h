@@ -4,20 +4,178 @@
 #ifndef EDMOND_H
 #define EDMOND_H
 
+#include <chrono>
 #include <queue>
+#include <string>
 
 #include "graph.h"
-#include "union_find.h"
+#include "dense_graph.h"
+#include "csr_graph.h"
 
-class EdmondsCardinalityMatching
+#include <stdint.h>
+
+/**
+ * Edmonds' algorithm working on the input graph type @a GraphT.
+ *
+ * The algorithm is compiled separately for each graph type, so that the
+ * neighbor iteration is inlined into the search loops. GraphT is a
+ * read-only graph view with the following members:
+ *
+ * @code
+ *   NodeID numNodes() const;
+ *   std::size_t degree(NodeID v) const;
+ *   Range neighbors(NodeID v) const; // begin()/end() iterate over NodeIDs
+ * @endcode
+ *
+ * Adjacency has to be symmetric. Instantiations are compiled into
+ * edmonds.cpp for Graph, DenseGraph, CSRGraph (arrays owned by the caller,
+ * also used for MappedGraph) and MaskedGraph<Graph>. For other graph views
+ * (e.g. BoostGraph from boost_graph.h), include edmonds_impl.h.
+ *
+ * For DenseGraph, the neighbor search scans 64 neighbors at once using
+ * bitsets of the current vertex types.
+ **/
+template<class GraphT>
+class BasicEdmondsMatching
 {
 public:
+	BasicEdmondsMatching();
+
+	/**
+	 * Restrict the search to short augmenting paths (approximation mode).
+	 *
+	 * The alternating trees are cut off at depth @a k, i.e. outer vertices
+	 * with @a k matching edges between them and their root do not grow the
+	 * tree any further. The search runs in phases with doubling depth
+	 * limits up to @a k, so that augmenting paths of length 2k+1 are
+	 * considered.
+	 *
+	 * This is a heuristic, there is no approximation guarantee: a matching
+	 * without augmenting paths of length <= 2k+1 would satisfy
+	 * |M| >= (1 - 1/(k+1)) * |M*|, but the search grows a single forest
+	 * greedily, so a short augmenting path can be missed if its vertices
+	 * were claimed by a tree which was cut off.
+	 *
+	 * @a k = 0 disables the limit (exact computation, the default).
+	 **/
+	void setDepthLimit(unsigned int k);
+
+	/**
+	 * Choose how an augmentation invalidates the scan state of the other
+	 * trees. Eager invalidation requeues all scanned neighbors of the
+	 * vertices of the destroyed trees immediately. Lazy invalidation (the
+	 * default) records the vertices which became out-of-forest. Once the
+	 * outer vertex queue runs empty, the trees of outer neighbors are grown
+	 * into those which are still out-of-forest.
+	 **/
+	void setLazyInvalidation(bool lazy);
+
+	/**
+	 * Keep @a scans neighbor scans of different outer vertices in flight.
+	 * Each scan prefetches the vertex state of its next neighbor and then
+	 * yields to the next scan, so that the cache misses of several scans
+	 * overlap. This pays off for graphs which do not fit into the cache.
+	 * 1 (the default) scans one outer vertex at a time. Ignored for
+	 * DenseGraph, whose neighbor search works on bitsets.
+	 **/
+	void setInterleave(unsigned int scans);
+
+	/**
+	 * Number of adjacency entries examined to invalidate the scan state
+	 * after augmentations during the last calculateMatching() call (see
+	 * setLazyInvalidation()).
+	 **/
+	std::size_t requeueWork() const
+	{ return m_requeueWork; }
+
+	/**
+	 * Write the current matching to the checkpoint file @a path (see
+	 * checkpoint.h) after an augmentation, if at least @a interval seconds
+	 * have passed since the last checkpoint. Pass the checkpoint as
+	 * initial matching to calculateMatching() to resume. An empty path
+	 * disables checkpoints (the default).
+	 **/
+	void setCheckpoint(const std::string& path, double interval);
+
+	/**
+	 * Estimated size of a maximum matching after the last
+	 * calculateMatching() call. In exact mode or if no tree had to be cut
+	 * off, this is the size of the computed matching, which is maximum.
+	 * Otherwise it is |M| + |M|/k, which is not a proven bound (see
+	 * setDepthLimit()).
+	 **/
+	std::size_t estimatedMaximum() const
+	{ return m_estimatedMaximum; }
+
+	/**
+	 * Time in seconds spent on setup and the greedy initialization in the
+	 * last calculateMatching() call, i.e. before the first search step.
+	 **/
+	double initTime() const
+	{ return m_initTime.count(); }
+
 	/**
 	 * Calculate a maximum matching in graph @a input and return it.
 	 *
 	 * Runtime: O(n^3), where n is the number of vertices.
 	 **/
-	void calculateMatching(const Graph& input, Graph& matching);
+	void calculateMatching(const GraphT& input, Graph& matching);
+
+	/**
+	 * Calculate a maximum matching in graph @a input. The result is
+	 * available through mates() afterwards.
+	 *
+	 * @return Size of the matching
+	 **/
+	std::size_t calculateMatching(const GraphT& input);
+
+	/**
+	 * Calculate a maximum matching in graph @a input, starting from the
+	 * matching @a initialMates (same format as mates()) instead of an
+	 * empty one. The initial matching is extended greedily first.
+	 *
+	 * @return Size of the matching
+	 **/
+	std::size_t calculateMatching(const GraphT& input, const LargeVector<NodeID>& initialMates);
+
+	/**
+	 * Result of the last calculateMatching() call: v is matched to
+	 * mates()[v], or unmatched if mates()[v] == v.
+	 **/
+	const LargeVector<NodeID>& mates() const
+	{ return m_mu; }
+
+	/**
+	 * Final forest of the last calculateMatching() call (exact mode only).
+	 * Each outer vertex is only adjacent to inner vertices and to outer
+	 * vertices of the same blossom (same blossomBase()). If this also holds
+	 * for the edges of a supergraph, the matching is maximum in the
+	 * supergraph as well (see SparsifiedMatching).
+	 **/
+	bool isOuter(NodeID v) const
+	{ return isOuterVertex(v); }
+
+	bool isInner(NodeID v) const
+	{ return isInnerVertex(v); }
+
+	NodeID blossomBase(NodeID v) const
+	{ return base(v); }
+
+	/**
+	 * Add the memory used by the solver state to @a usage. The arrays keep
+	 * their capacity between calls, so after calculateMatching() this is
+	 * the peak usage of the call, except for the outer vertex queue and
+	 * the forest lists of trees destroyed by augmentations, which are
+	 * released.
+	 **/
+	void memoryUsage(MemoryUsage* usage) const;
+
+	/**
+	 * Add the expected peak memory usage of calculateMatching() on a graph
+	 * with @a numNodes nodes to @a usage. The graph itself and the result
+	 * are not included.
+	 **/
+	static void estimateMemory(NodeID numNodes, MemoryUsage* usage);
 private:
 	//! Type of vertices in our graph: inner/outer/out-of-tree.
 	enum VertexType
@@ -39,6 +197,13 @@ private:
 	//! Check if @a v is outside of our forest (=> matched)
 	bool isOutOfForest(NodeID v) const;
 
+	/**
+	 * Update the vertex type bitsets for @a v after m_mu or m_phi changed.
+	 * This has to be called for all vertices whose type might have changed.
+	 * Only needed for DenseGraph, a no-op otherwise.
+	 **/
+	void updateType(NodeID v);
+
 	////////////////////////////////////////////////////////////////////////////
 	// Algorithm steps
 
@@ -54,13 +219,40 @@ private:
 	 * Search for an outer vertex or an out-of-forest vertex @a y adjacent
 	 * to @a x.
 	 *
+	 * Out-of-forest vertices are skipped if @a x is at the current depth
+	 * limit (see m_phaseDepth). In that case, m_truncated is set.
+	 *
 	 * @param y Output for the node ID
 	 * @param type Output for the vertex type
 	 **/
-	bool neighborSearch(NodeID x, NodeID* y, VertexType* type) const;
+	bool neighborSearch(NodeID x, NodeID* y, VertexType* type);
 
+	/**
+	 * Reset the tree state of @a v after an augmentation destroyed its
+	 * tree.
+	 **/
 	void removeVertexFromTree(NodeID v);
 
+	//! Requeue all scanned (outer) neighbors of @a v
+	void requeueScannedNeighbors(NodeID v);
+
+	/**
+	 * Grow the forest into the dirty vertices which are still
+	 * out-of-forest (lazy invalidation).
+	 **/
+	void growIntoDirtyVertices();
+
+	//! GROW operation: add out-of-forest @a y and its partner to the tree of outer @a x
+	void grow(NodeID x, NodeID y);
+
+	/**
+	 * GROW, SHRINK or AUGMENT at the edge from outer vertex @a x to the
+	 * neighbor @a y of type @a yType found by the neighbor search.
+	 *
+	 * @return false if the tree of x was destroyed (AUGMENT)
+	 **/
+	bool processEdge(NodeID x, NodeID y, VertexType yType);
+
 	/**
 	 * Augment the matching along the path created by the union of
 	 * Px and Py (and the edge between Px.front() and Py.front()).
@@ -68,21 +260,58 @@ private:
 	void augment(const std::vector<NodeID>& Px, const std::vector<NodeID>& Py);
 
 	/**
-	 * Follow the path @a path up to rIdx and make m_phi consistent with an
-	 * ear decomposition for the base at path[rIdx].
+	 * Find the base of the lowest common blossom of the outer vertices
+	 * @a x and @a y, which are in the same tree.
+	 *
+	 * We walk up from both sides in lockstep, one blossom per step, and
+	 * mark the visited bases. The first base reached which was already
+	 * marked by the other side is the result. This costs O(distance to
+	 * the common blossom) instead of O(depth) for both paths.
 	 **/
-	void convertPathToEar(const std::vector<NodeID>& path, unsigned int rIdx);
+	NodeID lowestCommonBase(NodeID x, NodeID y);
 
 	/**
-	 * Follow the path @a path and unite all ear decompositions with the
-	 * one at base r. This modifies m_rho accordingly.
+	 * Calculate the path from the outer vertex @a v up to the blossom with
+	 * base @a r, ending with the inner vertex through which it enters that
+	 * blossom (see pathToRoot()). The path is empty if v is in the blossom
+	 * already.
 	 **/
-	void uniteBasesAlongPath(const std::vector<NodeID>& path, NodeID r);
+	void pathToBlossom(NodeID v, NodeID r, std::vector<NodeID>* path) const;
 
 	/**
-	 * Apply the SHRINK operation to the blossom formed by Px,Py.
+	 * Make m_phi consistent with an ear decomposition for the blossom
+	 * entered by the path @a path (see pathToBlossom()).
 	 **/
-	void shrink(const std::vector<NodeID>& Px, const std::vector<NodeID>& Py);
+	void convertPathToEar(const std::vector<NodeID>& path);
+
+	/**
+	 * Merge all blossoms on the way from outer vertex @a x up to the
+	 * blossom with base @a r into the latter. Only visits one vertex per
+	 * blossom.
+	 **/
+	void uniteBlossomsAlongPath(NodeID x, NodeID r);
+
+	/**
+	 * Merge the blossoms @a a and @a b (as given by m_blossomOf). The
+	 * members of the smaller one are moved to the larger one.
+	 *
+	 * @return The blossom containing both
+	 **/
+	NodeID uniteBlossoms(NodeID a, NodeID b);
+
+	//! Number of vertices in blossom @a b
+	std::size_t blossomSize(NodeID b) const
+	{ return m_blossomMembers[b].empty() ? 1 : m_blossomMembers[b].size(); }
+
+	//! Base of the blossom containing @a v (O(1))
+	NodeID base(NodeID v) const
+	{ return m_blossomBase[m_blossomOf[v]]; }
+
+	/**
+	 * Apply the SHRINK operation to the blossom formed by the paths from
+	 * @a x and @a y to their common blossom and the edge {x,y}.
+	 **/
+	void shrink(NodeID x, NodeID y);
 
 	/**
 	 * Iterate on outer vertex x, until we cannot find any adjacent interesting
@@ -101,18 +330,45 @@ private:
 	 **/
 	void reset();
 
+	//! Allocate all arrays for @a input
+	void setup(const GraphT& input);
+
+	//! Extend m_mu greedily, processing vertices by increasing degree
+	void greedyMatching();
+
+	/**
+	 * Run the search phases starting from the matching in m_mu.
+	 *
+	 * @return Size of the matching
+	 **/
+	std::size_t run();
+
+	/**
+	 * Run the forest search until no unscanned outer vertex is left.
+	 **/
+	void search();
+
+	/**
+	 * Variant of search() which interleaves the neighbor scans of
+	 * m_interleave outer vertices (see setInterleave()).
+	 **/
+	void searchInterleaved();
+
+	//! Write a checkpoint if the checkpoint interval has passed
+	void writeCheckpoint();
+
 	//! Our input graph
-	const Graph* m_graph;
+	const GraphT* m_graph;
 
 	//! mu mapping: {v,w} in matching <=> m_mu[v] == w.
-	std::vector<NodeID> m_mu;
+	LargeVector<NodeID> m_mu;
 
 	/**
 	 * phi mapping as in lecture. In particular, phi and mu are associated
 	 * with an M-alternating ear-decomposition in each blossom. Furthermore,
 	 * phi points towards the tree root for all inner vertices.
 	 **/
-	std::vector<NodeID> m_phi;
+	LargeVector<NodeID> m_phi;
 
 	/**
 	 * Current outer vertex candidates.
@@ -127,24 +383,119 @@ private:
 	//! Has the vertex v been scanned completely?
 	std::vector<bool> m_scanned;
 
+	/**
+	 * Vertices which became out-of-forest after an augmentation since the
+	 * last growIntoDirtyVertices() call (lazy invalidation).
+	 **/
+	std::vector<NodeID> m_dirty;
+	std::vector<bool> m_isDirty;
+
+	//! See setLazyInvalidation()
+	bool m_lazyInvalidation;
+
+	//! See requeueWork()
+	std::size_t m_requeueWork;
+
+	//! See setInterleave()
+	unsigned int m_interleave;
+
+	//! Number of SHRINK and AUGMENT operations (see searchInterleaved())
+	uint64_t m_shrinkCount;
+	uint64_t m_augmentCount;
+
+	//! Bitsets of outer and out-of-forest vertices (see updateType())
+	LargeVector<uint64_t> m_outerBits;
+	LargeVector<uint64_t> m_outOfForestBits;
+
+	/**
+	 * Number of matching edges between v and its tree root. Only maintained
+	 * in approximation mode (see setDepthLimit()).
+	 **/
+	LargeVector<unsigned int> m_depth;
+
+	//! Maximum tree depth requested by setDepthLimit() (0: unlimited)
+	unsigned int m_depthLimit;
+
+	//! Tree depth limit of the current phase (0: unlimited)
+	unsigned int m_phaseDepth;
+
+	//! Did we refuse to grow a tree in the current phase?
+	bool m_truncated;
+
+	//! Result of estimatedMaximum()
+	std::size_t m_estimatedMaximum;
+
+	//! Result of initTime()
+	std::chrono::duration<double> m_initTime;
+
+	//! Checkpoint file (see setCheckpoint())
+	std::string m_checkpointPath;
+	std::chrono::duration<double> m_checkpointInterval;
+	std::chrono::steady_clock::time_point m_lastCheckpoint;
+	uint64_t m_fingerprint;
+
 	/**
 	 * Also record for each vertex to which tree root it belongs.
 	 **/
-	std::vector<NodeID> m_tree;
+	LargeVector<NodeID> m_tree;
 
 	/**
 	 * Keep track of the forest explicitly for fast tree deletion in augment().
 	 * This array contains an array of nodes belonging to the root v for each
-	 * node v in the graph.
+	 * node v in the graph. The inner lists are small heap blocks, which are
+	 * not covered by the memory policy (see memory::allocate()).
 	 **/
-	std::vector<std::vector<NodeID>> m_forest;
+	LargeVector<std::vector<NodeID>> m_forest;
 
 	/**
-	 * Union-Find structure for the blossom mapping rho.
+	 * Blossom records for the blossom mapping rho. Blossoms are identified
+	 * by one of their members: v is in blossom m_blossomOf[v], which has
+	 * the base m_blossomBase[b] and the members m_blossomMembers[b]. The
+	 * member list is empty for the singleton blossom {b}. Each vertex
+	 * outside of blossoms forms its own singleton blossom.
 	 *
-	 * v and w are in the same blossom, iff they are in the same class in rho.
+	 * rho(v) = m_blossomBase[m_blossomOf[v]] is found with two lookups.
+	 * Merging blossoms relabels the smaller one, so each vertex is moved
+	 * O(log n) times per tree. As for m_forest, the member lists are not
+	 * covered by the memory policy.
+	 **/
+	LargeVector<NodeID> m_blossomOf;
+	LargeVector<NodeID> m_blossomBase;
+	LargeVector<std::vector<NodeID>> m_blossomMembers;
+
+	/**
+	 * Marks for lowestCommonBase(): a base b was visited in the current
+	 * call if m_mark[b] is m_markStamp (from x) or m_markStamp+1 (from y).
 	 **/
-	UnionFind<NodeID> m_rho;
+	LargeVector<uint64_t> m_mark;
+	uint64_t m_markStamp;
+
+	//! Scratch paths for shrink()
+	std::vector<NodeID> m_pathX;
+	std::vector<NodeID> m_pathY;
 };
 
+// Specializations for DenseGraph (see edmonds.cpp)
+template<>
+void BasicEdmondsMatching<DenseGraph>::updateType(NodeID v);
+
+template<>
+bool BasicEdmondsMatching<DenseGraph>::neighborSearch(NodeID x, NodeID* y, VertexType* type);
+
+template<class GraphT>
+class MaskedGraph;
+
+// Compiled in edmonds.cpp
+extern template class BasicEdmondsMatching<Graph>;
+extern template class BasicEdmondsMatching<DenseGraph>;
+extern template class BasicEdmondsMatching<CSRGraph<uint32_t>>;
+extern template class BasicEdmondsMatching<CSRGraph<uint64_t>>;
+extern template class BasicEdmondsMatching<MaskedGraph<Graph>>;
+
+//! Edmonds' algorithm on sparse graphs
+typedef BasicEdmondsMatching<Graph> EdmondsCardinalityMatching;
+
+//! Edmonds' algorithm on dense graphs
+typedef BasicEdmondsMatching<DenseGraph> DenseEdmondsMatching;
+
 #endif
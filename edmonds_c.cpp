@@ -0,0 +1,106 @@
+// C interface for the edmonds matching library
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "edmonds_c.h"
+#include "edmonds.h"
+
+#include <new>
+
+struct edmonds_solver
+{
+	// One engine per index type, so that the working memory of each one
+	// is reused across calls.
+	BasicEdmondsMatching<CSRGraph<uint32_t>> engine32;
+	BasicEdmondsMatching<CSRGraph<uint64_t>> engine64;
+};
+
+namespace
+{
+	template<class Index, class Engine>
+	edmonds_status solve(Engine& engine, Index numNodes,
+		const Index* offsets, const Index* neighbors,
+		Index* mates, size_t* matchingSize)
+	{
+		if(!offsets || (!neighbors && offsets[numNodes] != 0) || (!mates && numNodes != 0))
+			return EDMONDS_INVALID_ARGUMENT;
+
+		CSRGraph<Index> graph(numNodes, offsets, neighbors);
+		if(!graph.isValid())
+			return EDMONDS_INVALID_ARGUMENT;
+
+		// Never let exceptions escape into C code
+		try
+		{
+			std::size_t size = engine.calculateMatching(graph);
+
+			const LargeVector<NodeID>& mu = engine.mates();
+			for(Index v = 0; v < numNodes; ++v)
+				mates[v] = (mu[v] == v) ? Index(-1) : Index(mu[v]);
+
+			if(matchingSize)
+				*matchingSize = size;
+		}
+		catch(std::bad_alloc&)
+		{
+			return EDMONDS_OUT_OF_MEMORY;
+		}
+		catch(...)
+		{
+			return EDMONDS_INTERNAL_ERROR;
+		}
+
+		return EDMONDS_OK;
+	}
+}
+
+int edmonds_api_version(void)
+{
+	return EDMONDS_API_VERSION;
+}
+
+const char* edmonds_status_string(edmonds_status status)
+{
+	switch(status)
+	{
+		case EDMONDS_OK:
+			return "OK";
+		case EDMONDS_INVALID_ARGUMENT:
+			return "Invalid argument";
+		case EDMONDS_OUT_OF_MEMORY:
+			return "Out of memory";
+		case EDMONDS_INTERNAL_ERROR:
+			return "Internal error";
+	}
+
+	return "Unknown status";
+}
+
+edmonds_solver* edmonds_solver_create(void)
+{
+	return new(std::nothrow) edmonds_solver;
+}
+
+void edmonds_solver_destroy(edmonds_solver* solver)
+{
+	delete solver;
+}
+
+edmonds_status edmonds_solve_csr32(edmonds_solver* solver,
+	uint32_t num_nodes, const uint32_t* offsets, const uint32_t* neighbors,
+	uint32_t* mates, size_t* matching_size)
+{
+	if(!solver)
+		return EDMONDS_INVALID_ARGUMENT;
+
+	return solve(solver->engine32, num_nodes, offsets, neighbors, mates, matching_size);
+}
+
+edmonds_status edmonds_solve_csr64(edmonds_solver* solver,
+	uint64_t num_nodes, const uint64_t* offsets, const uint64_t* neighbors,
+	uint64_t* mates, size_t* matching_size)
+{
+	if(!solver)
+		return EDMONDS_INVALID_ARGUMENT;
+
+	return solve(solver->engine64, num_nodes, offsets, neighbors, mates, matching_size);
+}
@@ -0,0 +1,82 @@
+/* C interface for the edmonds matching library
+ * Author: Max Schwarz <max.schwarz@uni-bonn.de>
+ *
+ * The input graph is given in compressed sparse row (CSR) format: The
+ * neighbors of node v are neighbors[offsets[v]] ... neighbors[offsets[v+1]-1]
+ * (0-based). Each undirected edge has to appear in the lists of both end
+ * nodes. The arrays are only read and not copied.
+ *
+ * The matching is returned as mate array of size num_nodes: node v is
+ * matched with mates[v], or unmatched if mates[v] == EDMONDS_UNMATCHED32
+ * (EDMONDS_UNMATCHED64 respectively).
+ *
+ * All functions are thread-safe as long as each solver handle is only used
+ * by one thread at a time.
+ */
+
+#ifndef EDMONDS_C_H
+#define EDMONDS_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define EDMONDS_EXPORT __attribute__((visibility("default")))
+#else
+#define EDMONDS_EXPORT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented on incompatible changes of this interface */
+#define EDMONDS_API_VERSION 1
+
+#define EDMONDS_UNMATCHED32 UINT32_MAX
+#define EDMONDS_UNMATCHED64 UINT64_MAX
+
+/* Return codes */
+typedef enum edmonds_status
+{
+	EDMONDS_OK = 0,
+	EDMONDS_INVALID_ARGUMENT = 1,  /* NULL pointer or invalid CSR arrays */
+	EDMONDS_OUT_OF_MEMORY = 2,
+	EDMONDS_INTERNAL_ERROR = 3
+} edmonds_status;
+
+/* Opaque solver handle. A solver keeps its working memory between calls,
+ * so repeated calls on graphs of similar size do not allocate. */
+typedef struct edmonds_solver edmonds_solver;
+
+/* Return EDMONDS_API_VERSION of the library */
+EDMONDS_EXPORT int edmonds_api_version(void);
+
+/* Return a static description of @a status */
+EDMONDS_EXPORT const char* edmonds_status_string(edmonds_status status);
+
+/* Create a solver handle. Returns NULL if out of memory. */
+EDMONDS_EXPORT edmonds_solver* edmonds_solver_create(void);
+
+/* Destroy a solver handle created by edmonds_solver_create() */
+EDMONDS_EXPORT void edmonds_solver_destroy(edmonds_solver* solver);
+
+/* Calculate a maximum matching of the CSR graph with 32-bit indices.
+ *
+ * @a offsets has num_nodes+1 entries, @a mates has num_nodes entries.
+ * If @a matching_size is not NULL, it receives the number of matched edges.
+ */
+EDMONDS_EXPORT edmonds_status edmonds_solve_csr32(edmonds_solver* solver,
+	uint32_t num_nodes, const uint32_t* offsets, const uint32_t* neighbors,
+	uint32_t* mates, size_t* matching_size);
+
+/* Same as edmonds_solve_csr32() with 64-bit indices */
+EDMONDS_EXPORT edmonds_status edmonds_solve_csr64(edmonds_solver* solver,
+	uint64_t num_nodes, const uint64_t* offsets, const uint64_t* neighbors,
+	uint64_t* mates, size_t* matching_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1045 @@
+// Edmonds' cardinality matching algorithm (template implementation)
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+// This file is only needed to instantiate BasicEdmondsMatching for new
+// graph types. The common instantiations are compiled in edmonds.cpp.
+
+// Hint: It's best to read this file bottom-up to go from general steps
+//  to specific methods.
+
+#ifndef EDMONDS_IMPL_H
+#define EDMONDS_IMPL_H
+
+#include "edmonds.h"
+#include "checkpoint.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <type_traits>
+
+template<class GraphT>
+BasicEdmondsMatching<GraphT>::BasicEdmondsMatching()
+ : m_graph(0)
+ , m_lazyInvalidation(true)
+ , m_requeueWork(0)
+ , m_interleave(1)
+ , m_shrinkCount(0)
+ , m_augmentCount(0)
+ , m_depthLimit(0)
+ , m_phaseDepth(0)
+ , m_truncated(false)
+ , m_estimatedMaximum(0)
+ , m_initTime(0.0)
+ , m_checkpointInterval(0.0)
+ , m_fingerprint(0)
+ , m_markStamp(0)
+{
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::setDepthLimit(unsigned int k)
+{
+	m_depthLimit = k;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::setLazyInvalidation(bool lazy)
+{
+	m_lazyInvalidation = lazy;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::setInterleave(unsigned int scans)
+{
+	m_interleave = std::max(scans, 1u);
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::setCheckpoint(const std::string& path, double interval)
+{
+	m_checkpointPath = path;
+	m_checkpointInterval = std::chrono::duration<double>(interval);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VERTEX TYPE
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::isOuterVertex(NodeID v) const
+{
+	return m_mu[v] == v || m_phi[m_mu[v]] != m_mu[v];
+}
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::isInnerVertex(NodeID v) const
+{
+	return m_phi[m_mu[v]] == m_mu[v] && m_phi[v] != v;
+}
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::isOutOfForest(NodeID v) const
+{
+	return m_mu[v] != v && m_phi[v] == v && m_phi[m_mu[v]] == m_mu[v];
+}
+
+template<class GraphT>
+typename BasicEdmondsMatching<GraphT>::VertexType BasicEdmondsMatching<GraphT>::vertexType(NodeID v) const
+{
+	if(isOuterVertex(v))
+		return OUTER;
+	else if(isInnerVertex(v))
+		return INNER;
+	else
+	{
+		assert(isOutOfForest(v));
+		return OUT_OF_FOREST;
+	}
+}
+
+template<class GraphT>
+inline void BasicEdmondsMatching<GraphT>::updateType(NodeID)
+{
+	// The sparse neighbor search does not need the type bitsets
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::reset()
+{
+	// Empty the outer vertex candidate queue
+	while(!m_outerVertices.empty())
+		m_outerVertices.pop();
+
+	m_dirty.clear();
+
+	for(NodeID v = 0; v < m_graph->numNodes(); ++v)
+	{
+		m_phi[v] = v;
+		m_tree[v] = v;
+		m_forest[v].clear();
+		m_blossomOf[v] = v;
+		m_blossomBase[v] = v;
+		m_blossomMembers[v].clear();
+		m_scanned[v] = false;
+		m_isDirty[v] = false;
+		m_depth[v] = 0;
+
+		if(isOuterVertex(v))
+			m_outerVertices.push(v);
+	}
+
+	// Vertex types depend on m_phi of the matching partner, so we can only
+	// update the type bitsets after the loop.
+	for(NodeID v = 0; v < m_graph->numNodes(); ++v)
+		updateType(v);
+}
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::findUnscannedOuterVertex(NodeID* dest)
+{
+	// Pop elements from the candidate queue until we find one which
+	// is an unscanned outer vertex.
+	do
+	{
+		// Before giving up, check the vertices which left a tree since
+		// the last check (lazy invalidation)
+		if(m_outerVertices.empty())
+		{
+			growIntoDirtyVertices();
+			if(m_outerVertices.empty())
+				return false;
+		}
+
+		*dest = m_outerVertices.front();
+		m_outerVertices.pop();
+	}
+	while(m_scanned[*dest] || !isOuterVertex(*dest));
+
+	return true;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::requeueScannedNeighbors(NodeID v)
+{
+	m_requeueWork += m_graph->degree(v);
+
+	for(NodeID w : m_graph->neighbors(v))
+	{
+		// If m_scanned[w] == false, this vertex is still in the queue
+		if(m_scanned[w])
+		{
+			m_outerVertices.push(w);
+			m_scanned[w] = false;
+		}
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::growIntoDirtyVertices()
+{
+	// A scanned outer vertex w had no out-of-forest neighbors at the time
+	// of its scan. So only vertices which left their tree afterwards can
+	// offer new work for w. Most of them have been grown into other trees
+	// again in the meantime. For the remaining out-of-forest vertices, we
+	// grow the tree of the first outer neighbor into them directly, instead
+	// of requeueing all their scanned neighbors. Afterwards, the vertex is
+	// inner, so its other neighbors cannot use it anymore.
+	for(std::size_t i = 0; i < m_dirty.size(); ++i)
+	{
+		NodeID v = m_dirty[i];
+		m_isDirty[v] = false;
+
+		if(!isOutOfForest(v))
+			continue;
+
+		for(NodeID w : m_graph->neighbors(v))
+		{
+			m_requeueWork++;
+
+			if(!isOuterVertex(w))
+				continue;
+
+			// Respect the depth limit as in neighborSearch()
+			if(m_phaseDepth && m_depth[w] >= m_phaseDepth)
+			{
+				m_truncated = true;
+				continue;
+			}
+
+			grow(w, v);
+			break;
+		}
+	}
+
+	m_dirty.clear();
+}
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::neighborSearch(NodeID x, NodeID* y, VertexType* type)
+{
+	NodeID xRho = base(x);
+
+	// Are we allowed to grow the tree at x?
+	bool grow = !m_phaseDepth || m_depth[x] < m_phaseDepth;
+
+	for(NodeID w : m_graph->neighbors(x))
+	{
+		VertexType t = vertexType(w);
+		if(t == OUT_OF_FOREST && !grow)
+		{
+			// Remember that the result of this phase is not exact
+			m_truncated = true;
+			continue;
+		}
+
+		if(t == OUT_OF_FOREST || (t == OUTER && base(w) != xRho))
+		{
+			*y = w;
+			*type = t;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<class GraphT>
+std::vector<NodeID> BasicEdmondsMatching<GraphT>::pathToRoot(NodeID v) const
+{
+	assert(isOuterVertex(v));
+
+	std::vector<NodeID> ret;
+	ret.push_back(v);
+
+	// Just follow the mu,phi mappings and construct the path until
+	// we hit an outer vertex with m_mu[v] == v.
+	while(v != m_mu[v])
+	{
+		v = m_mu[v];
+		ret.push_back(v);
+
+		v = m_phi[v];
+		ret.push_back(v);
+	}
+
+	return ret;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::removeVertexFromTree(NodeID v)
+{
+	m_phi[v] = v;
+	m_tree[v] = v;
+	m_depth[v] = 0;
+
+	// The whole tree is destroyed, so each blossom record is reset by
+	// its own vertex
+	m_blossomOf[v] = v;
+	m_blossomBase[v] = v;
+	m_blossomMembers[v].clear();
+
+	// If this vertex is unmatched, it is now an outer vertex and
+	// might be interesting for the outer vertex search
+	// (if it is matched, it is now out-of-forest)
+	if(m_mu[v] == v)
+		m_outerVertices.push(v);
+
+	bool wasScanned = m_scanned[v];
+	m_scanned[v] = false;
+
+	if(!m_lazyInvalidation)
+	{
+		// All adjacent outer vertices need to be reconsidered as their type
+		// of neighbor has changed.
+		requeueScannedNeighbors(v);
+		return;
+	}
+
+	// Exposed vertices search for their outer neighbors themselves. A
+	// vertex which was a scanned outer vertex of the destroyed tree cannot
+	// have scanned outer neighbors in other trees (one of them would have
+	// found the augmenting path), so it needs no attention either. For the
+	// remaining new out-of-forest vertices, we postpone the work until the
+	// queue runs empty.
+	if(m_mu[v] != v && !wasScanned && !m_isDirty[v])
+	{
+		m_isDirty[v] = true;
+		m_dirty.push_back(v);
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::augment(const std::vector<NodeID>& Px, const std::vector<NodeID>& Py)
+{
+	NodeID x = Px.front();
+	NodeID y = Py.front();
+
+	// change matching by M-alternating path Px, Py
+	for(unsigned int i = 1; i < Px.size(); i += 2)
+	{
+		NodeID v = Px[i];
+		m_mu[m_phi[v]] = v;
+		m_mu[v] = m_phi[v];
+	}
+	for(unsigned int i = 1; i < Py.size(); i += 2)
+	{
+		NodeID v = Py[i];
+		m_mu[m_phi[v]] = v;
+		m_mu[v] = m_phi[v];
+	}
+
+	// add edge {x,y} to matching
+	m_mu[x] = y;
+	m_mu[y] = x;
+
+	// reset phi, rho, scanned in the affected trees
+	NodeID rx = Px.back(); // root of x tree
+	NodeID ry = Py.back(); // root of y tree
+
+	// reset the root rx
+	removeVertexFromTree(rx);
+
+	// ... and all its descendants
+	for(NodeID v : m_forest[rx])
+		removeVertexFromTree(v);
+
+	// reset the root ry
+	removeVertexFromTree(ry);
+
+	// ... and all its descendants
+	for(NodeID v : m_forest[ry])
+		removeVertexFromTree(v);
+
+	// All types in both trees are settled now
+	updateType(rx);
+	for(NodeID v : m_forest[rx])
+		updateType(v);
+	updateType(ry);
+	for(NodeID v : m_forest[ry])
+		updateType(v);
+
+	// The roots are matched now and never become roots again, so release
+	// the lists instead of keeping their capacity
+	std::vector<NodeID>().swap(m_forest[rx]);
+	std::vector<NodeID>().swap(m_forest[ry]);
+}
+
+template<class GraphT>
+NodeID BasicEdmondsMatching<GraphT>::lowestCommonBase(NodeID x, NodeID y)
+{
+	// Marks a side which has passed its tree root
+	const NodeID NoNode = ~NodeID(0);
+
+	// Fresh marks for this call, the array never needs to be cleared
+	m_markStamp += 2;
+	const uint64_t markX = m_markStamp;
+	const uint64_t markY = m_markStamp + 1;
+
+	NodeID bx = base(x);
+	NodeID by = base(y);
+
+	while(1)
+	{
+		// One blossom up on the x side...
+		if(bx != NoNode)
+		{
+			if(m_mark[bx] == markY)
+				return bx;
+			m_mark[bx] = markX;
+
+			// The base of a blossom is matched to the inner vertex above
+			// it, whose phi points into the parent blossom.
+			bx = (m_mu[bx] == bx) ? NoNode : base(m_phi[m_mu[bx]]);
+		}
+
+		// ... and on the y side
+		if(by != NoNode)
+		{
+			if(m_mark[by] == markX)
+				return by;
+			m_mark[by] = markY;
+
+			by = (m_mu[by] == by) ? NoNode : base(m_phi[m_mu[by]]);
+		}
+
+		// Both vertices are in the same tree, so the sides meet at the
+		// latest at the root.
+		assert(bx != NoNode || by != NoNode);
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::pathToBlossom(NodeID v, NodeID r, std::vector<NodeID>* path) const
+{
+	assert(isOuterVertex(v));
+
+	path->clear();
+
+	// As pathToRoot(), but stop as soon as we enter the blossom of r.
+	// Paths leave each blossom through its base, so the last vertex is
+	// the inner vertex matched to the base of the last blossom below r.
+	while(base(v) != r)
+	{
+		path->push_back(v);
+
+		v = m_mu[v];
+		path->push_back(v);
+
+		v = m_phi[v];
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::convertPathToEar(const std::vector<NodeID>& P)
+{
+	if(P.empty())
+		return;
+
+	// The last vertex is the inner vertex where the path enters the
+	// blossom of r. Its phi pointer already points into that blossom.
+	m_outerVertices.push(P.back());
+
+	// Go one inner node further.
+	for(int i = P.size() - 3; i > 0; i -= 2)
+	{
+		NodeID v = P[i];
+
+		// Modify the phi pointer of our phi neighbor (outer vertex) to point
+		// back at us.
+		m_phi[m_phi[v]] = v;
+
+		// Old inner vertices become outer vertices in the blossom, so consider
+		// them during the next outer vertex search
+		m_outerVertices.push(v);
+	}
+}
+
+template<class GraphT>
+NodeID BasicEdmondsMatching<GraphT>::uniteBlossoms(NodeID a, NodeID b)
+{
+	if(blossomSize(a) < blossomSize(b))
+		std::swap(a, b);
+
+	std::vector<NodeID>& members = m_blossomMembers[a];
+	std::vector<NodeID>& moved = m_blossomMembers[b];
+
+	if(members.empty())
+		members.push_back(a);
+
+	if(moved.empty())
+	{
+		m_blossomOf[b] = a;
+		members.push_back(b);
+	}
+	else
+	{
+		for(NodeID v : moved)
+			m_blossomOf[v] = a;
+		members.insert(members.end(), moved.begin(), moved.end());
+		moved.clear();
+	}
+
+	return a;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::uniteBlossomsAlongPath(NodeID x, NodeID r)
+{
+	NodeID blossom = m_blossomOf[r];
+
+	NodeID b = base(x);
+	while(b != r)
+	{
+		assert(isOuterVertex(b));
+		assert(b != m_mu[b]);
+
+		// The inner vertex above b is not part of a blossom
+		NodeID inner = m_mu[b];
+		NodeID next = m_phi[inner];
+
+		blossom = uniteBlossoms(blossom, m_blossomOf[b]);
+		blossom = uniteBlossoms(blossom, m_blossomOf[inner]);
+
+		// The surviving record might have been one of the merged ones
+		m_blossomBase[blossom] = r;
+
+		b = base(next);
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::shrink(NodeID x, NodeID y)
+{
+	// SHRINK
+	// Find the base r of the lowest blossom on both P(x) and P(y)
+	NodeID r = lowestCommonBase(x, y);
+
+	// We only need the paths from x and y up to the blossom of r
+	pathToBlossom(x, r, &m_pathX);
+	pathToBlossom(y, r, &m_pathY);
+
+	// Fix the phi mapping to convert the path to an ear with base r
+	convertPathToEar(m_pathX);
+	convertPathToEar(m_pathY);
+
+	// Close phi over {x,y}
+	if(base(x) != r)
+		m_phi[x] = y;
+
+	if(base(y) != r)
+		m_phi[y] = x;
+
+	// Unite all blossoms we encounter along the way (include all ear
+	// decompositions our paths runs through into the new ear decomposition)
+	uniteBlossomsAlongPath(x, r);
+	uniteBlossomsAlongPath(y, r);
+
+	// Inner vertices along the paths became outer vertices
+	for(NodeID v : m_pathX)
+		updateType(v);
+	for(NodeID v : m_pathY)
+		updateType(v);
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::grow(NodeID x, NodeID y)
+{
+	m_phi[y] = x;
+
+	// Mark the two nodes as belonging to the current tree
+	m_tree[y] = m_tree[x];
+	m_tree[m_mu[y]] = m_tree[x];
+
+	m_depth[y] = m_depth[x] + 1;
+	m_depth[m_mu[y]] = m_depth[x] + 1;
+
+	updateType(y);
+	updateType(m_mu[y]);
+
+	m_forest[m_tree[x]].push_back(y);
+	m_forest[m_tree[x]].push_back(m_mu[y]);
+
+	// We got a new outer vertex
+	m_outerVertices.push(m_mu[y]);
+}
+
+template<class GraphT>
+bool BasicEdmondsMatching<GraphT>::processEdge(NodeID x, NodeID y, VertexType yType)
+{
+	if(yType == OUT_OF_FOREST)
+	{
+		grow(x, y);
+		return true;
+	}
+
+	// P(x) and P(y) are vertex-disjoint iff x and y are in different trees
+	if(m_tree[x] != m_tree[y])
+	{
+		// -> AUGMENT along P(x),P(y)
+		std::vector<NodeID> Px = pathToRoot(x);
+		std::vector<NodeID> Py = pathToRoot(y);
+		augment(Px, Py);
+		m_augmentCount++;
+		writeCheckpoint();
+		return false;
+	}
+	else
+	{
+		// The paths end in the same tree -> SHRINK the blossom
+		shrink(x, y);
+		m_shrinkCount++;
+		return true;
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::step(NodeID x)
+{
+	// As long as the tree is not reset and x is not exhausted, we
+	// can operate on x.
+	while(1)
+	{
+		assert(isOuterVertex(x) && !m_scanned[x]);
+
+		// Find a neighbor of x which is either out-of-tree
+		// or outer and part of different tree
+		NodeID y;
+		VertexType yType;
+
+		if(!neighborSearch(x, &y, &yType))
+		{
+			m_scanned[x] = true;
+			return;
+		}
+
+		// After the augment the current tree is destroyed
+		// -> exit the current iteration and continue with the outer scan
+		if(!processEdge(x, y, yType))
+			return;
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::search()
+{
+	if(m_interleave > 1 && !std::is_same<GraphT, DenseGraph>::value)
+	{
+		searchInterleaved();
+		return;
+	}
+
+	// Reset the forest pointers and init the outer vertex queue
+	reset();
+
+	// While there is an unscanned outer vertex x, call step(x)
+	NodeID x;
+	while(findUnscannedOuterVertex(&x))
+	{
+		step(x);
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::searchInterleaved()
+{
+	reset();
+
+	// Each scan is a small state machine which examines one neighbor w of
+	// its outer vertex x in three stages. The first two stages only issue
+	// prefetches for the state read by vertexType(w) and base(w)
+	// (the second depends on the first) and then yield to the next scan.
+	// By the time a scan gets its turn again, the data has hopefully
+	// arrived.
+	//
+	// Unlike step(), a scan continues after GROW and SHRINK with the next
+	// neighbor instead of starting over: the vertices which become outer
+	// are queued and will find x themselves. After an AUGMENT, the
+	// neighbors of x may have left their trees. With lazy invalidation,
+	// these are handled as dirty vertices, unless x lost its own tree. In
+	// that case or with eager invalidation, the scan starts over.
+	typedef decltype(m_graph->neighbors(0).begin()) NeighborIterator;
+
+	struct Scan
+	{
+		NodeID x;              // outer vertex being scanned
+		NodeID xRho;           // base of the blossom containing x
+		NodeID w;              // neighbor currently being examined
+		NeighborIterator it;   // position of w
+		NeighborIterator end;
+		unsigned int stage;    // 0: prefetch w, 1: prefetch mu(w), 2: examine w
+		uint64_t shrinkCount;  // m_shrinkCount when xRho was determined
+		uint64_t augmentCount; // m_augmentCount when the scan was (re)started
+	};
+
+	std::vector<Scan> scans;
+	scans.reserve(m_interleave);
+
+	bool queueEmpty = false;
+	std::size_t i = 0;
+
+	while(true)
+	{
+		// Fill free slots with new outer vertices
+		while(!queueEmpty && scans.size() < m_interleave)
+		{
+			NodeID x;
+			if(!findUnscannedOuterVertex(&x))
+			{
+				queueEmpty = true;
+				break;
+			}
+
+			// x might be in the queue more than once
+			bool active = false;
+			for(const Scan& scan : scans)
+				active = active || scan.x == x;
+			if(active)
+				continue;
+
+			auto&& range = m_graph->neighbors(x);
+			scans.push_back(Scan{x, base(x), 0, range.begin(), range.end(), 0, m_shrinkCount, m_augmentCount});
+		}
+
+		if(scans.empty())
+			break;
+
+		if(i >= scans.size())
+		{
+			i = 0;
+
+			// GROW, SHRINK and the dirty vertex processing queue new outer
+			// vertices, so look again after each round.
+			queueEmpty = false;
+		}
+
+		Scan& scan = scans[i];
+
+		if(scan.shrinkCount != m_shrinkCount || scan.augmentCount != m_augmentCount)
+		{
+			if(!isOuterVertex(scan.x) || m_scanned[scan.x])
+			{
+				// x left the forest or became inner
+				scan = scans.back();
+				scans.pop_back();
+				continue;
+			}
+
+			scan.xRho = base(scan.x);
+			scan.shrinkCount = m_shrinkCount;
+
+			// With lazy invalidation, only a root x might have lost its tree
+			// (see removeVertexFromTree()).
+			if(scan.augmentCount != m_augmentCount
+				&& (!m_lazyInvalidation || m_mu[scan.x] == scan.x))
+			{
+				auto&& range = m_graph->neighbors(scan.x);
+				scan.it = range.begin();
+				scan.end = range.end();
+				scan.stage = 0;
+			}
+
+			scan.augmentCount = m_augmentCount;
+		}
+
+		if(scan.stage == 2)
+		{
+			NodeID w = scan.w;
+			VertexType t = vertexType(w);
+
+			if(t == OUT_OF_FOREST && m_phaseDepth && m_depth[scan.x] >= m_phaseDepth)
+			{
+				// Remember that the result of this phase is not exact
+				m_truncated = true;
+			}
+			else if(t == OUT_OF_FOREST || (t == OUTER && base(w) != scan.xRho))
+			{
+				processEdge(scan.x, w, t);
+
+				// Check the state of this scan again in the next round
+				++scan.it;
+				scan.stage = 0;
+				++i;
+				continue;
+			}
+
+			// Nothing to do for w, continue with the next neighbor
+			// right away.
+			++scan.it;
+			scan.stage = 0;
+		}
+
+		if(scan.stage == 0)
+		{
+			if(!(scan.it != scan.end))
+			{
+				// x is exhausted
+				m_scanned[scan.x] = true;
+				scan = scans.back();
+				scans.pop_back();
+				continue;
+			}
+
+			NodeID w = *scan.it;
+			__builtin_prefetch(&m_mu[w]);
+			__builtin_prefetch(&m_phi[w]);
+			__builtin_prefetch(&m_blossomOf[w]);
+
+			scan.w = w;
+			scan.stage = 1;
+		}
+		else
+		{
+			__builtin_prefetch(&m_phi[m_mu[scan.w]]);
+			__builtin_prefetch(&m_blossomBase[m_blossomOf[scan.w]]);
+
+			scan.stage = 2;
+		}
+
+		++i;
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::writeCheckpoint()
+{
+	if(m_checkpointPath.empty())
+		return;
+
+	auto now = std::chrono::steady_clock::now();
+	if(now - m_lastCheckpoint < m_checkpointInterval)
+		return;
+
+	// The matching is consistent after each augmentation. Failing to write
+	// a checkpoint is not fatal, we try again after the next interval.
+	if(!checkpoint::write(m_checkpointPath, m_fingerprint, m_mu))
+		fprintf(stderr, "Warning: Could not write checkpoint: %s\n", strerror(errno));
+
+	m_lastCheckpoint = now;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::setup(const GraphT& input)
+{
+	// Setup pointer for other member methods
+	m_graph = &input;
+
+	// Setup mu, phi, rho pointers and reset m_scanned
+	m_mu.resize(input.numNodes());
+	m_phi.resize(input.numNodes());
+	m_blossomOf.resize(input.numNodes());
+	m_blossomBase.resize(input.numNodes());
+	m_blossomMembers.resize(input.numNodes());
+	m_mark.assign(input.numNodes(), 0);
+	m_markStamp = 0;
+	m_scanned.resize(input.numNodes());
+	m_isDirty.resize(input.numNodes());
+	m_requeueWork = 0;
+	m_tree.resize(input.numNodes());
+	m_forest.resize(input.numNodes());
+	m_depth.resize(input.numNodes());
+
+	if(std::is_same<GraphT, DenseGraph>::value)
+	{
+		m_outerBits.resize((input.numNodes() + 63) / 64);
+		m_outOfForestBits.resize((input.numNodes() + 63) / 64);
+	}
+
+	if(!m_checkpointPath.empty())
+	{
+		m_fingerprint = checkpoint::fingerprint(input);
+		m_lastCheckpoint = std::chrono::steady_clock::now();
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::greedyMatching()
+{
+	// Only exposed vertices can be matched. If we start from a maximal
+	// matching (e.g. built while loading, see ingestion.h), there are only
+	// a few of them.
+	std::vector<NodeID> exposed;
+	std::size_t maxDegree = 0;
+	for(NodeID v = 0; v < m_graph->numNodes(); ++v)
+	{
+		if(m_mu[v] == v)
+		{
+			exposed.push_back(v);
+			maxDegree = std::max(maxDegree, m_graph->degree(v));
+		}
+	}
+
+	// Sort the graph by vertex degree. This makes the initial greedy matching
+	// much more effective. The degrees are bounded by n, so we can use
+	// a counting sort (O(n) instead of O(n log n) degree comparisons).
+	std::vector<NodeID> offsets(maxDegree + 2, 0);
+	for(NodeID v : exposed)
+		offsets[m_graph->degree(v) + 1]++;
+	for(std::size_t d = 1; d < offsets.size(); ++d)
+		offsets[d] += offsets[d-1];
+
+	std::vector<NodeID> sorting(exposed.size());
+	for(NodeID v : exposed)
+		sorting[offsets[m_graph->degree(v)]++] = v;
+
+	// Start the algorithm with a greedy matching (takes O(m))
+	for(NodeID v : sorting)
+	{
+		if(m_mu[v] != v)
+			continue;
+
+		for(NodeID w : m_graph->neighbors(v))
+		{
+			if(m_mu[w] == w)
+			{
+				m_mu[w] = v;
+				m_mu[v] = w;
+				break;
+			}
+		}
+	}
+}
+
+template<class GraphT>
+std::size_t BasicEdmondsMatching<GraphT>::calculateMatching(const GraphT& input)
+{
+	auto start = std::chrono::steady_clock::now();
+	setup(input);
+
+	// Initialize empty matching
+	for(NodeID v = 0; v < input.numNodes(); ++v)
+		m_mu[v] = v;
+
+	greedyMatching();
+	m_initTime = std::chrono::steady_clock::now() - start;
+
+	return run();
+}
+
+template<class GraphT>
+std::size_t BasicEdmondsMatching<GraphT>::calculateMatching(
+	const GraphT& input, const LargeVector<NodeID>& initialMates
+)
+{
+	assert(initialMates.size() == input.numNodes());
+
+	auto start = std::chrono::steady_clock::now();
+	setup(input);
+	std::copy(initialMates.begin(), initialMates.end(), m_mu.begin());
+
+	greedyMatching();
+	m_initTime = std::chrono::steady_clock::now() - start;
+
+	return run();
+}
+
+template<class GraphT>
+std::size_t BasicEdmondsMatching<GraphT>::run()
+{
+	m_truncated = false;
+	if(m_depthLimit == 0)
+	{
+		m_phaseDepth = 0;
+		search();
+	}
+	else
+	{
+		// Approximation mode: Search for short augmenting paths first by
+		// doubling the depth limit in each phase. Each phase starts with a
+		// fresh forest, since the trees of the previous phase are cut off.
+		m_phaseDepth = 1;
+		while(1)
+		{
+			m_truncated = false;
+			search();
+
+			// If no tree was cut off, the matching is maximum
+			if(!m_truncated || m_phaseDepth == m_depthLimit)
+				break;
+
+			m_phaseDepth = std::min(2*m_phaseDepth, m_depthLimit);
+		}
+	}
+
+	std::size_t size = 0;
+	for(NodeID v = 0; v < m_graph->numNodes(); ++v)
+	{
+		if(m_mu[v] > v)
+			size++;
+	}
+
+	// Without augmenting paths of length <= 2k+1, we would have
+	// |M*| <= (k+1)/k * |M|. The truncated search does not ensure that,
+	// so this is only an estimate (see setDepthLimit()).
+	m_estimatedMaximum = size;
+	if(m_truncated)
+	{
+		m_estimatedMaximum = std::min<std::size_t>(
+			m_estimatedMaximum + m_estimatedMaximum / m_depthLimit,
+			m_graph->numNodes() / 2
+		);
+	}
+
+	return size;
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::calculateMatching(
+	const GraphT& input, Graph& matching
+)
+{
+	calculateMatching(input);
+
+	// Recover matching from m_mu
+	matching.reset(input.numNodes());
+
+	for(NodeID v = 0; v < input.numNodes(); ++v)
+	{
+		if(m_mu[v] > v)
+			matching.addEdge(v, m_mu[v]);
+	}
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::memoryUsage(MemoryUsage* usage) const
+{
+	usage->add("mu, phi", memory::bytes(m_mu) + memory::bytes(m_phi));
+	usage->add("tree roots", memory::bytes(m_tree));
+	usage->add("forest lists", memory::bytes(m_forest));
+	usage->add("blossom records",
+		memory::bytes(m_blossomOf) + memory::bytes(m_blossomBase)
+		+ memory::bytes(m_blossomMembers) + memory::bytes(m_mark)
+	);
+	usage->add("scan state",
+		memory::bytes(m_scanned) + memory::bytes(m_dirty) + memory::bytes(m_isDirty)
+		+ memory::bytes(m_outerBits) + memory::bytes(m_outOfForestBits)
+	);
+	usage->add("tree depths", memory::bytes(m_depth));
+}
+
+template<class GraphT>
+void BasicEdmondsMatching<GraphT>::estimateMemory(NodeID numNodes, MemoryUsage* usage)
+{
+	typedef std::vector<NodeID> List;
+
+	usage->add("mu, phi", 2 * numNodes * sizeof(NodeID));
+	usage->add("tree roots", numNodes * sizeof(NodeID));
+
+	// Each vertex is in one forest list and one member list at a time.
+	// The lists double their capacity and keep it after clear(), which
+	// costs up to twice the entries (and the heap block overhead).
+	usage->add("forest lists", numNodes * (sizeof(List) + 3 * sizeof(NodeID)));
+	usage->add("blossom records",
+		numNodes * (3 * sizeof(NodeID) + sizeof(uint64_t) + sizeof(List) + 3 * sizeof(NodeID))
+	);
+
+	// Dirty list and outer vertex queue hold each vertex at most once
+	usage->add("scan state", numNodes * (2 * sizeof(NodeID)) + numNodes / 4);
+	usage->add("tree depths", numNodes * sizeof(unsigned int));
+}
+
+#endif
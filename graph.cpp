@@ -2,6 +2,8 @@
 // Author: Max Schwarz <max.schwarz@uni-bonn.de>
 
 #include "graph.h"
+#include "dimac.h"
+#include "graph_formats.h"
 
 #include <assert.h>
 #include <string.h>
@@ -35,74 +37,41 @@ void Graph::addEdge(NodeID v, NodeID w)
 	m_edges.emplace_back(v, w);
 }
 
+namespace
+{
+	//! parseDIMAC() / parseGraph() handler which fills a Graph
+	class GraphBuilder
+	{
+	public:
+		explicit GraphBuilder(Graph* graph)
+		 : m_graph(graph)
+		{}
+
+		void header(NodeID numNodes, std::size_t)
+		{ m_graph->reset(numNodes); }
+
+		void edge(NodeID v, NodeID w)
+		{ m_graph->addEdge(v, w); }
+	private:
+		Graph* m_graph;
+	};
+}
+
 void Graph::loadDIMAC(std::istream& stream)
 {
-	bool initialized = false;
+	GraphBuilder builder(this);
+	parseDIMAC(stream, builder);
+}
 
-	while(!stream.eof())
-	{
-		std::string line;
-		std::getline(stream, line);
-
-		if(line.length() == 0 || line[0] == '\n')
-			continue;
-
-		if(line.substr(0, 7) == "p edge ")
-		{
-			if(initialized)
-				throw LoadError("Found more than one DIMAC header (p ...)");
-
-			unsigned int n, m;
-			if(sscanf(line.c_str(), "p edge %u %u", &n, &m) != 2)
-				throw LoadError("Could not parse DIMAC header");
-
-			reset(n);
-			initialized = true;
-		}
-		else if(line[0] == 'e' && line[1] == ' ')
-		{
-			NodeID v, w;
-
-			// Use strtoul to parse the node indices since sscanf is
-			// surprisingly slow
-
-			// Format: e v w
-			char* endptr = 0;
-			v = strtoul(line.data() + 2, &endptr, 10);
-
-			if(*endptr != ' ')
-				throw LoadError("Invalid edge specification");
-
-			// Skip whitespace between v and w
-			while(*endptr == ' ')
-				endptr++;
-
-			// Parse w
-			w = strtoul(endptr, &endptr, 10);
-			if(*endptr != 0 && *endptr != ' ')
-				throw LoadError("Invalid edge specification");
-
-			// Sanity check
-			if(v == 0 || w == 0)
-				throw LoadError("Zero node indices in edge spec");
-
-			// DIMAC is 1-based, we are 0-based
-			v -= 1;
-			w -= 1;
-
-			if(v >= numNodes() || w >= numNodes())
-				throw LoadError("Node indices out of bounds in edge spec");
-
-			addEdge(v, w);
-		}
-		else if(line[0] == 'c')
-		{
-		}
-		else
-		{
-			fprintf(stderr, "Warning: Unknown DIMAC line: '%s'\n", line.c_str());
-		}
-	}
+void Graph::load(std::istream& stream)
+{
+	load(stream, formats::AUTO);
+}
+
+void Graph::load(std::istream& stream, formats::Format format)
+{
+	GraphBuilder builder(this);
+	parseGraph(stream, builder, 0, format);
 }
 
 void Graph::toDIMAC(std::ostream& stream)
@@ -115,3 +84,26 @@ void Graph::toDIMAC(std::ostream& stream)
 		stream << "e " << (e.first+1) << " " << (e.second+1) << "\n";
 	}
 }
+
+void Graph::memoryUsage(MemoryUsage* usage) const
+{
+	std::size_t adjacency = 0;
+	for(const Node& node : m_nodes)
+		adjacency += memory::bytes(node.m_adjacent);
+
+	usage->add("graph nodes", memory::bytes(m_nodes));
+	usage->add("graph adjacency lists", adjacency);
+	usage->add("graph edge list", memory::bytes(m_edges));
+}
+
+void Graph::estimateMemory(NodeID numNodes, std::size_t numEdges, MemoryUsage* usage)
+{
+	// The edge list doubles its capacity as well
+	std::size_t edgeCapacity = 1;
+	while(edgeCapacity < numEdges)
+		edgeCapacity *= 2;
+
+	usage->add("graph nodes", numNodes * sizeof(Node));
+	usage->add("graph adjacency lists", 3 * numEdges * sizeof(NodeID) + 16 * numNodes);
+	usage->add("graph edge list", edgeCapacity * sizeof(Edge));
+}
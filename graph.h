@@ -4,6 +4,9 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "allocator.h"
+#include "memory_usage.h"
+
 #include <vector>
 #include <iostream>
 
@@ -11,6 +14,11 @@
 
 class Graph;
 
+namespace formats
+{
+	enum Format : int;
+}
+
 typedef std::size_t NodeID;
 
 /**
@@ -24,6 +32,7 @@ public:
 	const std::vector<NodeID>& adjacent() const
 	{ return m_adjacent; }
 private:
+	//! Small heap block per node, not covered by the memory policy (see memory::allocate())
 	std::vector<NodeID> m_adjacent;
 };
 
@@ -57,6 +66,14 @@ public:
 	const Node& node(NodeID id) const
 	{ return m_nodes[id]; }
 
+	//! Return the adjacent nodes of @a v
+	const std::vector<NodeID>& neighbors(NodeID v) const
+	{ return m_nodes[v].m_adjacent; }
+
+	//! Return the number of adjacent nodes of @a v
+	std::size_t degree(NodeID v) const
+	{ return m_nodes[v].m_adjacent.size(); }
+
 	//! Return number of nodes in the graph
 	unsigned int numNodes() const
 	{ return m_nodeCount; }
@@ -65,19 +82,39 @@ public:
 	unsigned int numEdges() const
 	{ return m_edges.size(); }
 
-	const std::vector<Edge>& edges() const
+	const LargeVector<Edge>& edges() const
 	{ return m_edges; }
 
 	//! Load a DIMAC graph from stream @a stream
 	void loadDIMAC(std::istream& stream);
 
+	/**
+	 * Load a graph in DIMAC, METIS, Matrix Market or SNAP format from
+	 * stream @a stream. The format is detected automatically.
+	 **/
+	void load(std::istream& stream);
+
+	//! Load a graph in format @a format (see parseGraph())
+	void load(std::istream& stream, formats::Format format);
+
 	//! Write a DIMAC graph into stream @a stream
 	void toDIMAC(std::ostream& stream);
+
+	//! Add the memory used by the graph to @a usage
+	void memoryUsage(MemoryUsage* usage) const;
+
+	/**
+	 * Add the expected memory usage of a Graph with @a numNodes nodes and
+	 * @a numEdges edges (built with addEdge()) to @a usage. The adjacency
+	 * vectors grow by doubling, so they are about 1.5 times as large as
+	 * needed, plus the heap overhead of one block per node.
+	 **/
+	static void estimateMemory(NodeID numNodes, std::size_t numEdges, MemoryUsage* usage);
 private:
-	std::vector<Node> m_nodes;
+	LargeVector<Node> m_nodes;
 	std::size_t m_nodeCount;
 
-	std::vector<Edge> m_edges;
+	LargeVector<Edge> m_edges;
 };
 
 #endif
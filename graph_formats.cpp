@@ -0,0 +1,588 @@
+// Loaders for METIS, Matrix Market and SNAP graph files
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "graph_formats.h"
+#include "scanner.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+namespace formats
+{
+
+const char* name(Format format)
+{
+	switch(format)
+	{
+		case DIMAC:         return "DIMAC";
+		case METIS:         return "METIS";
+		case MATRIX_MARKET: return "Matrix Market";
+		case SNAP:          return "SNAP";
+		case SNAP_0_BASED:  return "SNAP (0-based)";
+		case SNAP_1_BASED:  return "SNAP (1-based)";
+		case AUTO:          return "auto";
+	}
+
+	return "unknown";
+}
+
+bool fromName(const char* str, Format* format)
+{
+	static const struct { const char* name; Format format; } names[] = {
+		{"auto", AUTO},
+		{"dimac", DIMAC},
+		{"metis", METIS},
+		{"mtx", MATRIX_MARKET},
+		{"snap", SNAP},
+		{"snap0", SNAP_0_BASED},
+		{"snap1", SNAP_1_BASED},
+	};
+
+	for(const auto& entry : names)
+	{
+		if(!strcmp(str, entry.name))
+		{
+			*format = entry.format;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Format fromExtension(const char* path)
+{
+	std::string name = path;
+
+	auto hasSuffix = [&](const char* suffix) {
+		std::size_t len = strlen(suffix);
+		return name.size() >= len && name.compare(name.size() - len, len, suffix) == 0;
+	};
+
+	// Compression is detected from the contents (see CompressedInput)
+	if(hasSuffix(".gz"))
+		name.resize(name.size() - 3);
+	else if(hasSuffix(".zst"))
+		name.resize(name.size() - 4);
+
+	if(hasSuffix(".dmx"))
+		return DIMAC;
+	if(hasSuffix(".graph") || hasSuffix(".metis"))
+		return METIS;
+	if(hasSuffix(".mtx"))
+		return MATRIX_MARKET;
+
+	return AUTO;
+}
+
+namespace
+{
+	// Minimum chunk size per parsing thread
+	const std::size_t MinChunkSize = 1 << 20;
+
+	/**
+	 * Call func(begin, end) for each line in [begin,end). The newline is not
+	 * part of the line. A final empty segment without newline is not a line.
+	 **/
+	template<class Func>
+	void forEachLine(const char* begin, const char* end, Func func)
+	{
+		const char* p = begin;
+		while(p != end)
+		{
+			const char* newline = (const char*)memchr(p, '\n', end - p);
+			const char* lineEnd = newline ? newline : end;
+			func(p, lineEnd);
+			p = newline ? newline + 1 : end;
+		}
+	}
+
+	bool isComment(const char* p, const char* end, char commentChar)
+	{
+		p = scanner::skipBlanks(p, end);
+		return p != end && *p == commentChar;
+	}
+
+	bool isBlankLine(const char* p, const char* end)
+	{
+		return scanner::skipBlanks(p, end) == end;
+	}
+
+	//! Return the first line in [p,end) which is not empty or a comment
+	const char* skipComments(const char* p, const char* end, char commentChar)
+	{
+		while(p != end)
+		{
+			const char* lineEnd = scanner::nextLine(p, end);
+			if(!isComment(p, lineEnd, commentChar) && !scanner::atLineEnd(p, lineEnd))
+				break;
+			p = lineEnd;
+		}
+
+		return p;
+	}
+
+	uint64_t parseNumber(const char*& p, const char* end, const char* error)
+	{
+		p = scanner::skipBlanks(p, end);
+
+		uint64_t value;
+		if(!scanner::parseUInt(p, end, &value))
+			throw Graph::LoadError(error);
+
+		return value;
+	}
+
+	//! Split [begin,end) into at most @a count chunks at line boundaries
+	std::vector<const char*> splitLines(const char* begin, const char* end, unsigned int count)
+	{
+		count = std::max<std::size_t>(1, std::min<std::size_t>(count, (end - begin) / MinChunkSize + 1));
+
+		std::vector<const char*> bounds(1, begin);
+		for(unsigned int i = 1; i < count; ++i)
+		{
+			const char* p = std::max(bounds.back(), begin + (end - begin) / count * i);
+			bounds.push_back(scanner::nextLine(p, end));
+		}
+		bounds.push_back(end);
+
+		return bounds;
+	}
+
+	//! Edges found in one chunk
+	struct Chunk
+	{
+		Chunk()
+		 : maxID(0)
+		 , hasZero(false)
+		{}
+
+		std::vector<Graph::Edge> edges;
+		NodeID maxID;
+		bool hasZero;
+		std::string error;
+	};
+
+	/**
+	 * Run func(i) for all chunks in parallel, then rethrow the first error
+	 * reported by a chunk.
+	 **/
+	template<class Func>
+	void forEachChunk(std::vector<Chunk>* chunks, Func func)
+	{
+		auto run = [&](unsigned int i) {
+			try
+			{
+				func(i);
+			}
+			catch(Graph::LoadError& e)
+			{
+				(*chunks)[i].error = e.what();
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for(unsigned int i = 1; i < chunks->size(); ++i)
+			threads.emplace_back(run, i);
+		run(0);
+
+		for(std::thread& thread : threads)
+			thread.join();
+
+		for(const Chunk& chunk : *chunks)
+		{
+			if(!chunk.error.empty())
+				throw Graph::LoadError(chunk.error);
+		}
+	}
+
+	//! Add edge {v,w} (0-based) to @a chunk, ignoring self loops
+	inline void addEdge(Chunk* chunk, NodeID v, NodeID w)
+	{
+		if(v == w)
+			return;
+
+		if(v > w)
+			std::swap(v, w);
+
+		chunk->edges.emplace_back(v, w);
+	}
+
+	//! Sort and deduplicate the edges of @a chunk
+	void normalize(Chunk* chunk)
+	{
+		std::sort(chunk->edges.begin(), chunk->edges.end());
+		chunk->edges.erase(std::unique(chunk->edges.begin(), chunk->edges.end()), chunk->edges.end());
+	}
+
+	//! Merge the normalized chunks into @a edges
+	void merge(std::vector<Chunk>* chunks, std::vector<Graph::Edge>* edges)
+	{
+		std::size_t total = 0;
+		for(const Chunk& chunk : *chunks)
+			total += chunk.edges.size();
+
+		edges->clear();
+		edges->reserve(total);
+
+		for(Chunk& chunk : *chunks)
+		{
+			std::size_t middle = edges->size();
+			edges->insert(edges->end(), chunk.edges.begin(), chunk.edges.end());
+			std::vector<Graph::Edge>().swap(chunk.edges);
+
+			std::inplace_merge(edges->begin(), edges->begin() + middle, edges->end());
+		}
+
+		edges->erase(std::unique(edges->begin(), edges->end()), edges->end());
+	}
+
+	void parseMETIS(const char* data, const char* end, EdgeList* list, unsigned int threads)
+	{
+		const char* p = skipComments(data, end, '%');
+		const char* headerEnd = scanner::nextLine(p, end);
+
+		NodeID numNodes = parseNumber(p, headerEnd, "Could not parse METIS header");
+		std::size_t numEdges = parseNumber(p, headerEnd, "Could not parse METIS header");
+
+		// Optional fmt field: [vertex sizes][vertex weights][edge weights]
+		bool vertexSizes = false;
+		bool vertexWeights = false;
+		bool edgeWeights = false;
+		unsigned int ncon = 0;
+
+		p = scanner::skipBlanks(p, headerEnd);
+		if(!scanner::atLineEnd(p, headerEnd))
+		{
+			const char* fmt = p;
+			p = scanner::skipToken(p, headerEnd);
+			std::string flags(fmt, p);
+			if(flags.size() > 3 || flags.find_first_not_of("01") != std::string::npos)
+				throw Graph::LoadError("Invalid METIS fmt field");
+			flags.insert(0, 3 - flags.size(), '0');
+
+			vertexSizes = (flags[0] == '1');
+			vertexWeights = (flags[1] == '1');
+			edgeWeights = (flags[2] == '1');
+
+			if(vertexWeights)
+			{
+				ncon = 1;
+				p = scanner::skipBlanks(p, headerEnd);
+				if(!scanner::atLineEnd(p, headerEnd))
+					ncon = parseNumber(p, headerEnd, "Invalid METIS ncon field");
+			}
+		}
+
+		unsigned int skip = (vertexSizes ? 1 : 0) + (vertexWeights ? ncon : 0);
+
+		// Determine the first node of each chunk by counting the adjacency
+		// lines in parallel
+		std::vector<const char*> bounds = splitLines(headerEnd, end, threads);
+		std::vector<Chunk> chunks(bounds.size() - 1);
+		std::vector<NodeID> firstNode(chunks.size() + 1, 0);
+
+		forEachChunk(&chunks, [&](unsigned int i) {
+			NodeID count = 0;
+			forEachLine(bounds[i], bounds[i+1], [&](const char* line, const char* lineEnd) {
+				if(!isComment(line, lineEnd, '%'))
+					count++;
+			});
+			firstNode[i+1] = count;
+		});
+
+		for(std::size_t i = 1; i < firstNode.size(); ++i)
+			firstNode[i] += firstNode[i-1];
+
+		forEachChunk(&chunks, [&](unsigned int i) {
+			NodeID v = firstNode[i];
+			Chunk* chunk = &chunks[i];
+
+			forEachLine(bounds[i], bounds[i+1], [&](const char* line, const char* lineEnd) {
+				if(isComment(line, lineEnd, '%'))
+					return;
+
+				if(v >= numNodes)
+				{
+					if(!isBlankLine(line, lineEnd))
+						throw Graph::LoadError("More METIS adjacency lines than nodes");
+					return;
+				}
+
+				const char* q = line;
+				for(unsigned int j = 0; j < skip; ++j)
+					q = scanner::skipToken(scanner::skipBlanks(q, lineEnd), lineEnd);
+
+				while(!scanner::atLineEnd(q, lineEnd))
+				{
+					NodeID w = parseNumber(q, lineEnd, "Invalid METIS adjacency line");
+					if(w == 0 || w > numNodes)
+						throw Graph::LoadError("Node indices out of bounds in METIS adjacency line");
+
+					if(edgeWeights)
+						q = scanner::skipToken(scanner::skipBlanks(q, lineEnd), lineEnd);
+
+					// METIS is 1-based, we are 0-based
+					addEdge(chunk, v, w - 1);
+				}
+
+				v++;
+			});
+
+			normalize(chunk);
+		});
+
+		list->numNodes = numNodes;
+		merge(&chunks, &list->edges);
+
+		if(list->edges.size() != numEdges)
+		{
+			fprintf(stderr, "Warning: METIS header specifies %lu edges, found %lu\n",
+				numEdges, list->edges.size()
+			);
+		}
+	}
+
+	void parseMatrixMarket(const char* data, const char* end, EdgeList* list, unsigned int threads)
+	{
+		// %%MatrixMarket matrix coordinate <field> <symmetry>
+		const char* bannerEnd = scanner::nextLine(data, end);
+		std::string banner(data, bannerEnd);
+		std::transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+
+		if(banner.find(" coordinate") == std::string::npos)
+			throw Graph::LoadError("Only coordinate Matrix Market files are supported");
+
+		const char* p = skipComments(bannerEnd, end, '%');
+		const char* sizeEnd = scanner::nextLine(p, end);
+
+		uint64_t rows = parseNumber(p, sizeEnd, "Could not parse Matrix Market size line");
+		uint64_t cols = parseNumber(p, sizeEnd, "Could not parse Matrix Market size line");
+		parseNumber(p, sizeEnd, "Could not parse Matrix Market size line");
+
+		if(rows != cols)
+			throw Graph::LoadError("Matrix Market input is not a square matrix");
+
+		// Entries are given either for one triangle (symmetric matrices) or
+		// for both (general matrices), which is handled by deduplication.
+		std::vector<const char*> bounds = splitLines(sizeEnd, end, threads);
+		std::vector<Chunk> chunks(bounds.size() - 1);
+
+		forEachChunk(&chunks, [&](unsigned int i) {
+			Chunk* chunk = &chunks[i];
+
+			forEachLine(bounds[i], bounds[i+1], [&](const char* line, const char* lineEnd) {
+				if(isComment(line, lineEnd, '%') || isBlankLine(line, lineEnd))
+					return;
+
+				// Format: i j [value]
+				const char* q = line;
+				uint64_t v = parseNumber(q, lineEnd, "Invalid Matrix Market entry");
+				uint64_t w = parseNumber(q, lineEnd, "Invalid Matrix Market entry");
+
+				if(v == 0 || w == 0 || v > rows || w > rows)
+					throw Graph::LoadError("Node indices out of bounds in Matrix Market entry");
+
+				// Matrix Market is 1-based, we are 0-based
+				addEdge(chunk, v - 1, w - 1);
+			});
+
+			normalize(chunk);
+		});
+
+		list->numNodes = rows;
+		merge(&chunks, &list->edges);
+	}
+
+	/**
+	 * Node ID base given by a leading comment line of a SNAP file, e.g.
+	 * "# Nodes are 1-based". Returns -1 if there is no such comment.
+	 **/
+	int snapBase(const char* data, const char* end)
+	{
+		const char* p = data;
+		while(p != end)
+		{
+			const char* lineEnd = scanner::nextLine(p, end);
+			if(!isComment(p, lineEnd, '#') && !isComment(p, lineEnd, '%') && !isBlankLine(p, lineEnd))
+				break;
+
+			std::string line(p, lineEnd);
+			if(line.find("0-based") != std::string::npos)
+				return 0;
+			if(line.find("1-based") != std::string::npos)
+				return 1;
+
+			p = lineEnd;
+		}
+
+		return -1;
+	}
+
+	void parseSNAP(const char* data, const char* end, Format format, EdgeList* list, unsigned int threads)
+	{
+		std::vector<const char*> bounds = splitLines(data, end, threads);
+		std::vector<Chunk> chunks(bounds.size() - 1);
+
+		forEachChunk(&chunks, [&](unsigned int i) {
+			Chunk* chunk = &chunks[i];
+
+			forEachLine(bounds[i], bounds[i+1], [&](const char* line, const char* lineEnd) {
+				if(isComment(line, lineEnd, '#') || isComment(line, lineEnd, '%') || isBlankLine(line, lineEnd))
+					return;
+
+				// Format: v w [additional columns]
+				const char* q = line;
+				NodeID v = parseNumber(q, lineEnd, "Invalid SNAP edge line");
+				NodeID w = parseNumber(q, lineEnd, "Invalid SNAP edge line");
+
+				chunk->maxID = std::max(chunk->maxID, std::max(v, w));
+				if(v == 0 || w == 0)
+					chunk->hasZero = true;
+
+				addEdge(chunk, v, w);
+			});
+
+			normalize(chunk);
+		});
+
+		NodeID maxID = 0;
+		bool hasZero = false;
+		for(const Chunk& chunk : chunks)
+		{
+			maxID = std::max(maxID, chunk.maxID);
+			hasZero = hasZero || chunk.hasZero;
+		}
+
+		merge(&chunks, &list->edges);
+
+		if(list->edges.empty())
+		{
+			list->numNodes = 0;
+			return;
+		}
+
+		int base = -1;
+		if(format == SNAP_0_BASED)
+			base = 0;
+		else if(format == SNAP_1_BASED)
+			base = 1;
+		else
+			base = snapBase(data, end);
+
+		// SNAP files are usually 0-based. Without node 0, assume they are
+		// 1-based, but say so.
+		if(base < 0)
+		{
+			base = hasZero ? 0 : 1;
+			if(base == 1)
+				fprintf(stderr, "Warning: SNAP input does not contain node 0, assuming 1-based node IDs. "
+					"Add a '# 0-based' or '# 1-based' comment line to choose explicitly.\n");
+		}
+
+		if(base == 0)
+		{
+			list->numNodes = maxID + 1;
+			return;
+		}
+
+		if(hasZero)
+			throw Graph::LoadError("Node ID 0 in 1-based SNAP input");
+
+		// Shifting all IDs keeps the edges sorted
+		list->numNodes = maxID;
+		for(Graph::Edge& e : list->edges)
+		{
+			e.first--;
+			e.second--;
+		}
+	}
+}
+
+Format detect(const char* data, std::size_t size)
+{
+	const char* end = data + size;
+	const char* p = data;
+
+	// Skip leading blank lines
+	while(p != end && (scanner::isBlank(*p) || *p == '\n'))
+		++p;
+
+	if(end - p >= 14 && strncmp(p, "%%MatrixMarket", 14) == 0)
+		return MATRIX_MARKET;
+
+	if(p != end && *p == '#')
+		return SNAP;
+
+	// A METIS header "n m [fmt [ncon]]" is followed by exactly n adjacency
+	// lines (apart from trailing empty lines), which is very unlikely for
+	// an edge list.
+	p = skipComments(p, end, '%');
+	const char* headerEnd = scanner::nextLine(p, end);
+
+	uint64_t fields[4];
+	unsigned int numFields = 0;
+	while(!scanner::atLineEnd(p, headerEnd))
+	{
+		p = scanner::skipBlanks(p, headerEnd);
+		if(numFields == 4 || !scanner::parseUInt(p, headerEnd, &fields[numFields]))
+			return SNAP;
+		numFields++;
+	}
+
+	if(numFields < 2)
+		return SNAP;
+
+	uint64_t lines = 0;
+	uint64_t lastNonBlank = 0;
+	forEachLine(headerEnd, end, [&](const char* line, const char* lineEnd) {
+		if(isComment(line, lineEnd, '%'))
+			return;
+		lines++;
+		if(!isBlankLine(line, lineEnd))
+			lastNonBlank = lines;
+	});
+
+	if(lastNonBlank <= fields[0] && fields[0] <= lines)
+	{
+		throw Graph::LoadError(
+			"Input could be a METIS graph or a SNAP edge list. Use a .graph "
+			"extension or --format metis/snap to choose explicitly"
+		);
+	}
+
+	return SNAP;
+}
+
+void parseEdgeList(const char* data, std::size_t size, Format format, EdgeList* list, unsigned int threads)
+{
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	const char* end = data + size;
+
+	switch(format)
+	{
+		case METIS:
+			parseMETIS(data, end, list, threads);
+			break;
+		case MATRIX_MARKET:
+			parseMatrixMarket(data, end, list, threads);
+			break;
+		case SNAP:
+		case SNAP_0_BASED:
+		case SNAP_1_BASED:
+			parseSNAP(data, end, format, list, threads);
+			break;
+		case DIMAC:
+		case AUTO:
+			throw Graph::LoadError("DIMAC input is handled by parseDIMAC()");
+	}
+}
+
+}
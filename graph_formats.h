@@ -0,0 +1,141 @@
+// Loaders for METIS, Matrix Market and SNAP graph files
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef GRAPH_FORMATS_H
+#define GRAPH_FORMATS_H
+
+#include "graph.h"
+#include "dimac.h"
+
+#include <istream>
+#include <vector>
+
+namespace formats
+{
+
+enum Format : int
+{
+	AUTO,          //!< detect from the file contents (see detect())
+	DIMAC,         //!< "p edge n m" header, "e v w" lines, 1-based
+	METIS,         //!< "n m [fmt [ncon]]" header, one adjacency line per node, 1-based
+	MATRIX_MARKET, //!< "%%MatrixMarket matrix coordinate ..." square matrix, 1-based
+	SNAP,          //!< "v w" lines, "#" comments, base from a comment or guessed
+	SNAP_0_BASED,  //!< SNAP edge list with 0-based IDs
+	SNAP_1_BASED   //!< SNAP edge list with 1-based IDs
+};
+
+//! Human-readable name of @a format
+const char* name(Format format);
+
+/**
+ * Parse a format name as given on the command line (auto, dimac, metis, mtx,
+ * snap, snap0 or snap1).
+ *
+ * @return false if @a str is not a format name
+ **/
+bool fromName(const char* str, Format* format);
+
+/**
+ * Format implied by the extension of @a path (.dmx, .graph/.metis or .mtx,
+ * optionally followed by .gz or .zst). Returns AUTO for other extensions.
+ **/
+Format fromExtension(const char* path);
+
+/**
+ * Detect the format of the graph file contents @a data. Only distinguishes
+ * Matrix Market and SNAP (DIMAC is recognized by parseGraph()).
+ *
+ * METIS files are not detected: a METIS header followed by n adjacency
+ * lines cannot be told apart from a small edge list reliably. Such input
+ * is rejected, the format has to be given explicitly.
+ *
+ * @throw Graph::LoadError if the contents could be METIS or SNAP
+ **/
+Format detect(const char* data, std::size_t size);
+
+//! Undirected edge list as produced by parseEdgeList()
+struct EdgeList
+{
+	NodeID numNodes;
+
+	//! Edges (v,w) with v < w, sorted and without duplicates
+	std::vector<Graph::Edge> edges;
+};
+
+/**
+ * Parse the graph file contents @a data in format @a format (not DIMAC or AUTO)
+ * using @a threads threads (0: hardware concurrency).
+ *
+ * Node IDs are converted to 0-based IDs. For SNAP, a leading comment line
+ * containing "0-based" or "1-based" sets the base. Without such a comment,
+ * files that do not contain node 0 are considered 1-based and a warning is
+ * printed. Self loops are removed and edges given in
+ * both directions (as in METIS files or non-symmetric matrices) are
+ * reported only once.
+ *
+ * @throw Graph::LoadError on malformed input
+ **/
+void parseEdgeList(const char* data, std::size_t size, Format format, EdgeList* list, unsigned int threads = 0);
+
+}
+
+/**
+ * Parse a graph in any supported format (DIMAC, METIS, Matrix Market or
+ * SNAP) from @a stream and report it to @a handler (see parseDIMAC()).
+ * With @a format == formats::AUTO, the format is detected from the
+ * contents.
+ *
+ * DIMAC input is parsed while reading. The other formats are read into
+ * memory first and parsed in parallel, since edges need to be deduplicated
+ * before the header can be reported.
+ *
+ * @throw Graph::LoadError on malformed input
+ **/
+template<class Handler>
+void parseGraph(std::istream& stream, Handler& handler, unsigned int threads = 0,
+	formats::Format format = formats::AUTO)
+{
+	if(format == formats::DIMAC)
+	{
+		parseDIMAC(stream, handler);
+		return;
+	}
+
+	if(format == formats::AUTO)
+	{
+		// DIMAC files start with comments or the header. Leading whitespace
+		// is ignored by parseDIMAC() anyway.
+		stream >> std::ws;
+		int c = stream.peek();
+		if(c == 'c' || c == 'p' || c == std::istream::traits_type::eof())
+		{
+			parseDIMAC(stream, handler);
+			return;
+		}
+	}
+
+	std::vector<char> data;
+	const std::size_t BlockSize = 1 << 20;
+	while(stream)
+	{
+		std::size_t offset = data.size();
+		data.resize(offset + BlockSize);
+		stream.read(data.data() + offset, BlockSize);
+		data.resize(offset + stream.gcount());
+	}
+
+	if(format == formats::AUTO)
+		format = formats::detect(data.data(), data.size());
+
+	formats::EdgeList list;
+	formats::parseEdgeList(data.data(), data.size(), format, &list, threads);
+
+	// Release the file contents before the handler builds the graph
+	std::vector<char>().swap(data);
+
+	handler.header(list.numNodes, list.edges.size());
+	for(const Graph::Edge& e : list.edges)
+		handler.edge(e.first, e.second);
+}
+
+#endif
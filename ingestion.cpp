@@ -0,0 +1,99 @@
+// Overlapped graph ingestion: parsing, graph construction and greedy matching
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "ingestion.h"
+
+OnlineGreedyMatching::OnlineGreedyMatching()
+ : m_size(0)
+{
+}
+
+void OnlineGreedyMatching::reset(NodeID numNodes)
+{
+	m_mates.resize(numNodes);
+	for(NodeID v = 0; v < numNodes; ++v)
+		m_mates[v] = v;
+
+	m_size = 0;
+}
+
+namespace ingestion_detail
+{
+
+MessageQueue::MessageQueue(std::size_t capacity)
+ : m_capacity(capacity)
+ , m_closed(false)
+{
+}
+
+bool MessageQueue::push(Message&& msg)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_notFull.wait(lock, [&]() { return m_closed || m_messages.size() < m_capacity; });
+
+	if(m_closed)
+		return false;
+
+	m_messages.push_back(std::move(msg));
+	m_notEmpty.notify_one();
+	return true;
+}
+
+bool MessageQueue::pop(Message* msg)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_notEmpty.wait(lock, [&]() { return m_closed || !m_messages.empty(); });
+
+	// Deliver the remaining messages after the parser finished
+	if(m_messages.empty())
+		return false;
+
+	*msg = std::move(m_messages.front());
+	m_messages.pop_front();
+	m_notFull.notify_one();
+	return true;
+}
+
+void MessageQueue::close()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_closed = true;
+	m_notEmpty.notify_all();
+	m_notFull.notify_all();
+}
+
+Batcher::Batcher(MessageQueue* queue)
+ : m_queue(queue)
+{
+	m_batch.isHeader = false;
+	m_batch.edges.reserve(BatchSize);
+}
+
+void Batcher::header(NodeID numNodes, std::size_t numEdges)
+{
+	Message msg;
+	msg.isHeader = true;
+	msg.numNodes = numNodes;
+	msg.numEdges = numEdges;
+	send(std::move(msg));
+}
+
+void Batcher::flush()
+{
+	if(m_batch.edges.empty())
+		return;
+
+	send(std::move(m_batch));
+
+	m_batch = Message();
+	m_batch.isHeader = false;
+	m_batch.edges.reserve(BatchSize);
+}
+
+void Batcher::send(Message&& msg)
+{
+	if(!m_queue->push(std::move(msg)))
+		throw Aborted();
+}
+
+}
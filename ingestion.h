@@ -0,0 +1,210 @@
+// Overlapped graph ingestion: parsing, graph construction and greedy matching
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef INGESTION_H
+#define INGESTION_H
+
+#include "graph.h"
+#include "graph_formats.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Maximal matching which is built while the edges arrive: an edge is added
+ * if both end points are still exposed. The result can be passed as
+ * initial matching to BasicEdmondsMatching::calculateMatching(), so that
+ * the search starts right after loading.
+ **/
+class OnlineGreedyMatching
+{
+public:
+	OnlineGreedyMatching();
+
+	//! Start with an empty matching on @a numNodes nodes
+	void reset(NodeID numNodes);
+
+	//! Add edge {v,w} to the matching if v and w are exposed
+	void edge(NodeID v, NodeID w)
+	{
+		if(m_mates[v] == v && m_mates[w] == w && v != w)
+		{
+			m_mates[v] = w;
+			m_mates[w] = v;
+			m_size++;
+		}
+	}
+
+	//! v is matched to mates()[v], or unmatched if mates()[v] == v
+	const LargeVector<NodeID>& mates() const
+	{ return m_mates; }
+
+	//! Size of the matching
+	std::size_t size() const
+	{ return m_size; }
+private:
+	LargeVector<NodeID> m_mates;
+	std::size_t m_size;
+};
+
+namespace ingestion_detail
+{
+	enum
+	{
+		BatchSize = 1 << 16, //!< Edges per message
+		QueueCapacity = 8    //!< Messages in flight
+	};
+
+	//! Header or batch of edges sent from the parser thread
+	struct Message
+	{
+		bool isHeader;
+		NodeID numNodes;
+		std::size_t numEdges;
+		std::vector<Graph::Edge> edges;
+	};
+
+	//! Bounded queue between the parser thread and the consumer
+	class MessageQueue
+	{
+	public:
+		explicit MessageQueue(std::size_t capacity);
+
+		/**
+		 * Append @a msg, blocks while the queue is full.
+		 *
+		 * @return false if the queue was closed
+		 **/
+		bool push(Message&& msg);
+
+		/**
+		 * Remove the first message, blocks while the queue is empty.
+		 *
+		 * @return false if the queue is empty and closed
+		 **/
+		bool pop(Message* msg);
+
+		//! Wake up all waiting threads, push() fails afterwards
+		void close();
+	private:
+		std::size_t m_capacity;
+		bool m_closed;
+		std::deque<Message> m_messages;
+		std::mutex m_mutex;
+		std::condition_variable m_notEmpty;
+		std::condition_variable m_notFull;
+	};
+
+	//! Thrown in the parser thread if the consumer gave up
+	struct Aborted {};
+
+	//! parseGraph() handler which batches the edges into the queue
+	class Batcher
+	{
+	public:
+		explicit Batcher(MessageQueue* queue);
+
+		void header(NodeID numNodes, std::size_t numEdges);
+		void edge(NodeID v, NodeID w)
+		{
+			m_batch.edges.emplace_back(v, w);
+			if(m_batch.edges.size() == BatchSize)
+				flush();
+		}
+
+		//! Send the remaining edges
+		void flush();
+	private:
+		void send(Message&& msg);
+
+		MessageQueue* m_queue;
+		Message m_batch;
+	};
+}
+
+/**
+ * Parse a graph with parseGraph() in a separate thread and report it to
+ * @a handler (see parseDIMAC()) in the calling thread. Edges are passed
+ * over in batches through a short queue, so that the graph can be built
+ * (e.g. together with an OnlineGreedyMatching) while the parser reads
+ * ahead. @a format is passed on to parseGraph().
+ *
+ * @throw Graph::LoadError on malformed input
+ **/
+template<class Handler>
+void parseGraphPipelined(std::istream& stream, Handler& handler, unsigned int threads = 0,
+	formats::Format format = formats::AUTO)
+{
+	using namespace ingestion_detail;
+
+	MessageQueue queue(QueueCapacity);
+	std::exception_ptr error;
+
+	std::thread parser([&]() {
+		try
+		{
+			Batcher batcher(&queue);
+			parseGraph(stream, batcher, threads, format);
+			batcher.flush();
+		}
+		catch(Aborted&)
+		{
+		}
+		catch(...)
+		{
+			error = std::current_exception();
+		}
+
+		queue.close();
+	});
+
+	try
+	{
+		Message msg;
+		while(queue.pop(&msg))
+		{
+			if(msg.isHeader)
+				handler.header(msg.numNodes, msg.numEdges);
+			else
+			{
+				for(const Graph::Edge& e : msg.edges)
+					handler.edge(e.first, e.second);
+			}
+		}
+	}
+	catch(...)
+	{
+		// Stop the parser before passing on the error
+		queue.close();
+		parser.join();
+		throw;
+	}
+
+	parser.join();
+
+	if(error)
+		std::rethrow_exception(error);
+}
+
+/**
+ * Maximum memory used by parseGraphPipelined() for the edge batches in
+ * flight, for DIMAC input with @a numEdges edges. Other formats are read
+ * into memory completely before the edges are reported.
+ **/
+inline std::size_t pipelineBufferSize(std::size_t numEdges)
+{
+	using namespace ingestion_detail;
+
+	// Each batch reserves BatchSize edges, the consumer and the parser
+	// hold one batch each.
+	std::size_t batches = std::min<std::size_t>(QueueCapacity, numEdges / BatchSize + 1) + 2;
+	return batches * BatchSize * sizeof(Graph::Edge);
+}
+
+#endif
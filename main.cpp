@@ -3,36 +3,1124 @@
 
 #include "graph.h"
 #include "edmonds.h"
+#include "streaming.h"
+#include "graph_formats.h"
+#include "tutte.h"
+#include "server.h"
+#include "subgraph_matching.h"
+#include "mapped_graph.h"
+#include "matching_writer.h"
+#include "compressed_input.h"
+#include "checkpoint.h"
+#include "weighted_matching.h"
+#include "ingestion.h"
+#include "sparsify.h"
+#include "csr_builder.h"
+#include "memory_usage.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <memory>
+#include <chrono>
 
-int main(int argc, char** argv)
+//! Memory needed to solve and print the result for a graph with @a numNodes nodes
+static void estimateSolveMemory(NodeID numNodes, unsigned int outputThreads, MemoryUsage* usage)
 {
-	if(argc != 2 || !strcmp(argv[1], "--help") || !strcmp(argv[1], "-h"))
+	MemoryUsage solver;
+	EdmondsCardinalityMatching::estimateMemory(numNodes, &solver);
+	usage->add("solver: ", solver);
+
+	MatchingWriter writer;
+	if(outputThreads != 0)
+		writer.setThreads(outputThreads);
+	usage->add("output buffers", writer.bufferSize(numNodes));
+}
+
+/**
+ * parseGraph() handler which loads the input either into a Graph or into a
+ * DenseGraph, depending on the density.
+ *
+ * If a memory budget is set, the peak memory usage is estimated from the
+ * header. If the default representation does not fit, the graph is loaded
+ * into compact CSR arrays instead (see CSRGraphBuilder), and the output is
+ * formatted by a single thread. If nothing fits, loading fails right after
+ * the header.
+ **/
+struct GraphLoader
+{
+	enum Representation
 	{
-		fprintf(stderr, "Usage: edmonds <input DIMAC file>\n");
-		return 1;
+		GRAPH,
+		DENSE,
+		CSR32,
+		CSR64
+	};
+
+	//! What happens with the graph after loading
+	enum Purpose
+	{
+		SOLVE,    //!< Calculate a maximum matching
+		WRITE_CSR //!< Write a binary CSR file
+	};
+
+	GraphLoader()
+	 : representation(GRAPH)
+	 , matchWhileLoading(false)
+	 , maxMemory(0)
+	 , purpose(SOLVE)
+	 , flatArrays(false)
+	 , outputThreads(0)
+	 , estimatedPeak(0)
+	{}
+
+	static const char* name(Representation rep)
+	{
+		switch(rep)
+		{
+			case GRAPH: return "adjacency lists";
+			case DENSE: return "adjacency matrix";
+			case CSR32: return "32-bit CSR";
+			case CSR64: return "64-bit CSR";
+		}
+		return "";
+	}
+
+	void header(NodeID numNodes, std::size_t numEdges)
+	{
+		chooseRepresentation(numNodes, numEdges);
+
+		switch(representation)
+		{
+			case GRAPH: graph.reset(numNodes); break;
+			case DENSE: denseGraph.reset(numNodes); break;
+			case CSR32: csr32.reset(numNodes, numEdges); break;
+			case CSR64: csr64.reset(numNodes, numEdges); break;
+		}
+
+		if(matchWhileLoading)
+			greedy.reset(numNodes);
+	}
+
+	void edge(NodeID v, NodeID w)
+	{
+		switch(representation)
+		{
+			case GRAPH: graph.addEdge(v, w); break;
+			case DENSE: denseGraph.addEdge(v, w); break;
+			case CSR32: csr32.addEdge(v, w); break;
+			case CSR64: csr64.addEdge(v, w); break;
+		}
+
+		if(matchWhileLoading)
+			greedy.edge(v, w);
+	}
+
+	//! Call after parsing to build the CSR arrays
+	void finish()
+	{
+		if(representation == CSR32)
+			csr32.finish();
+		else if(representation == CSR64)
+			csr64.finish();
+	}
+
+	/**
+	 * Estimate the memory needed to load @a numNodes nodes and @a numEdges
+	 * edges into @a rep and to process the graph afterwards.
+	 *
+	 * @return Estimated peak usage in bytes
+	 **/
+	std::size_t estimate(Representation rep, NodeID numNodes, std::size_t numEdges,
+		unsigned int threads, MemoryUsage* usage) const
+	{
+		std::size_t loading = pipelineBufferSize(numEdges);
+		switch(rep)
+		{
+			case GRAPH: Graph::estimateMemory(numNodes, numEdges, usage); break;
+			case DENSE: DenseGraph::estimateMemory(numNodes, usage); break;
+			case CSR32: loading += CSRGraphBuilder<uint32_t>::estimateMemory(numNodes, numEdges, usage); break;
+			case CSR64: loading += CSRGraphBuilder<uint64_t>::estimateMemory(numNodes, numEdges, usage); break;
+		}
+
+		if(matchWhileLoading)
+			usage->add("greedy matching", numNodes * sizeof(NodeID));
+
+		std::size_t resident = usage->total();
+		usage->add("input buffers (loading only)", loading);
+
+		// Processing starts after the input buffers are released
+		MemoryUsage processing;
+		if(purpose == SOLVE)
+			estimateSolveMemory(numNodes, threads, &processing);
+		else
+			processing.add("CSR file buffer", (numNodes + 1) * sizeof(uint64_t));
+		usage->add("", processing);
+
+		return resident + std::max(loading, processing.total());
+	}
+
+	void chooseRepresentation(NodeID numNodes, std::size_t numEdges)
+	{
+		Representation compact = CSRGraphBuilder<uint32_t>::fits(numNodes, numEdges) ? CSR32 : CSR64;
+		Representation preferred = GRAPH;
+		if(DenseGraph::isDense(numNodes, numEdges))
+			preferred = DENSE;
+		else if(flatArrays)
+			preferred = compact;
+
+		representation = preferred;
+		if(maxMemory == 0)
+			return;
+
+		// Candidates by decreasing speed and memory usage
+		std::vector<Representation> candidates{preferred};
+		if(compact != preferred)
+			candidates.push_back(compact);
+
+		std::vector<unsigned int> threadChoices{outputThreads};
+		if(outputThreads != 1)
+			threadChoices.push_back(1);
+
+		MemoryUsage smallest;
+		std::size_t smallestPeak = 0;
+		Representation smallestRep = preferred;
+		for(Representation rep : candidates)
+		{
+			for(unsigned int threads : threadChoices)
+			{
+				MemoryUsage usage;
+				std::size_t peak = estimate(rep, numNodes, numEdges, threads, &usage);
+				if(peak <= maxMemory)
+				{
+					representation = rep;
+					outputThreads = threads;
+					estimatedUsage = usage;
+					estimatedPeak = peak;
+					return;
+				}
+
+				if(smallestPeak == 0 || peak < smallestPeak)
+				{
+					smallest = usage;
+					smallestPeak = peak;
+					smallestRep = rep;
+				}
+			}
+		}
+
+		fprintf(stderr, "Estimated memory usage (%s):\n", name(smallestRep));
+		smallest.print(stderr, "estimated peak", smallestPeak);
+
+		char msg[256];
+		snprintf(msg, sizeof(msg), "Graph with %lu nodes and %lu edges needs about %s "
+			"even as %s, which exceeds --max-memory %s (--stream needs O(n) memory)",
+			numNodes, numEdges, memory::formatSize(smallestPeak).c_str(),
+			name(smallestRep), memory::formatSize(maxMemory).c_str()
+		);
+		throw Graph::LoadError(msg);
 	}
 
+	//! Add the memory used by the graph to @a usage
+	void memoryUsage(MemoryUsage* usage) const
+	{
+		switch(representation)
+		{
+			case GRAPH: graph.memoryUsage(usage); break;
+			case DENSE: denseGraph.memoryUsage(usage); break;
+			case CSR32: csr32.memoryUsage(usage); break;
+			case CSR64: csr64.memoryUsage(usage); break;
+		}
+
+		if(matchWhileLoading)
+			usage->add("greedy matching", memory::bytes(greedy.mates()));
+	}
+
+	Representation representation;
 	Graph graph;
+	DenseGraph denseGraph;
+	CSRGraphBuilder<uint32_t> csr32;
+	CSRGraphBuilder<uint64_t> csr64;
+
+	//! Build a greedy matching during loading (see OnlineGreedyMatching)
+	bool matchWhileLoading;
+	OnlineGreedyMatching greedy;
+
+	//! Memory budget in bytes (0: unlimited)
+	std::size_t maxMemory;
+	Purpose purpose;
+
+	/**
+	 * Load sparse graphs into CSR arrays instead of a Graph. The memory
+	 * policy (huge pages, NUMA placement) only applies to large arrays, but
+	 * the adjacency lists of a Graph are small heap blocks.
+	 **/
+	bool flatArrays;
+
+	//! Threads for writing the matching, reduced to 1 if memory is tight
+	unsigned int outputThreads;
+
+	//! Estimate for the chosen representation (only with a budget)
+	MemoryUsage estimatedUsage;
+	std::size_t estimatedPeak;
+};
+
+//! Write the matching given by @a mates to stdout
+static void writeMatching(const NodeID* mates, NodeID numNodes, std::size_t size, unsigned int threads,
+	MemoryUsage* usage = 0)
+{
+	MatchingWriter writer;
+	if(threads != 0)
+		writer.setThreads(threads);
+
+	if(!writer.write(STDOUT_FILENO, mates, numNodes, size))
+	{
+		perror("Could not write matching");
+		exit(1);
+	}
+
+	if(usage)
+		usage->add("output buffers", writer.bufferSize(numNodes));
+}
+
+//! Print the per-structure memory usage (see --memory-stats) to stderr
+static void printMemoryUsage(const MemoryUsage& usage)
+{
+	fprintf(stderr, "Memory usage:\n");
+	usage.print(stderr);
+	fprintf(stderr, "Peak resident set size: %s\n",
+		memory::formatSize(memory::peakResidentSize()).c_str()
+	);
+}
+
+//! Options for solve()
+struct SolveOptions
+{
+	SolveOptions()
+	 : depthLimit(0)
+	 , threads(0)
+	 , checkpoint(0)
+	 , checkpointInterval(300.0)
+	 , resume(false)
+	 , interleave(1)
+	 , initialMates(0)
+	 , memory(0)
+	{}
+
+	unsigned int depthLimit;
+	unsigned int threads;
+	const char* checkpoint;
+	double checkpointInterval;
+	bool resume;
+	unsigned int interleave;
+
+	//! Start from this matching instead of an empty one (may be null)
+	const LargeVector<NodeID>* initialMates;
+
+	//! Add the memory usage of the solver and the output here (may be null)
+	MemoryUsage* memory;
+};
+
+template<class Matching, class GraphT>
+static void solve(const GraphT& graph, const SolveOptions& options)
+{
+	Matching edmond;
+	edmond.setDepthLimit(options.depthLimit);
+	edmond.setInterleave(options.interleave);
+
+	if(options.checkpoint)
+		edmond.setCheckpoint(options.checkpoint, options.checkpointInterval);
+
+	std::size_t size;
+	if(options.resume && access(options.checkpoint, F_OK) == 0)
+	{
+		LargeVector<NodeID> mates;
+		try
+		{
+			checkpoint::read(options.checkpoint, graph.numNodes(), checkpoint::fingerprint(graph), &mates);
+			checkpoint::validate(graph, mates);
+		}
+		catch(Graph::LoadError& e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			exit(1);
+		}
+
+		std::size_t matched = 0;
+		for(NodeID v = 0; v < mates.size(); ++v)
+		{
+			if(mates[v] > v)
+				matched++;
+		}
+		fprintf(stderr, "Resuming from checkpoint with matching size %lu\n", matched);
+
+		size = edmond.calculateMatching(graph, mates);
+	}
+	else if(options.initialMates)
+		size = edmond.calculateMatching(graph, *options.initialMates);
+	else
+		size = edmond.calculateMatching(graph);
+
+	if(options.memory)
+	{
+		MemoryUsage solver;
+		edmond.memoryUsage(&solver);
+		options.memory->add("solver: ", solver);
+	}
+
+	// Write the mate array directly, building a Graph just for output is
+	// expensive on large inputs.
+	writeMatching(edmond.mates().data(), graph.numNodes(), size, options.threads, options.memory);
+
+	if(options.depthLimit != 0)
+	{
+		fprintf(stderr, "Approximate matching (k = %u): size %lu, estimated maximum %lu\n",
+			options.depthLimit, size, edmond.estimatedMaximum()
+		);
+	}
+}
+
+/**
+ * Answer the subgraph queries in @a stream (see --queries) in parallel and
+ * print the matching sizes.
+ **/
+static int runQueries(const Graph& graph, std::istream& stream, unsigned int numThreads)
+{
+	// Parse all queries first
+	struct Query
+	{
+		std::vector<NodeID> nodes;
+		std::vector<Graph::Edge> edges;
+	};
+	std::vector<Query> queries;
+
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		if(line.empty() || line[0] == 'c')
+			continue;
+
+		Query query;
+		std::istringstream ss(line);
+		std::string type;
+		while(ss >> type)
+		{
+			NodeID v, w;
+			if(type == "v" && (ss >> v) && v >= 1 && v <= graph.numNodes())
+				query.nodes.push_back(v-1);
+			else if(type == "e" && (ss >> v >> w) && v >= 1 && w >= 1
+				&& v <= graph.numNodes() && w <= graph.numNodes())
+				query.edges.emplace_back(v-1, w-1);
+			else
+			{
+				fprintf(stderr, "Invalid query: '%s'\n", line.c_str());
+				return 1;
+			}
+		}
+
+		queries.push_back(query);
+	}
+
+	// Base matching for warm starts
+	EdmondsCardinalityMatching edmond;
+	edmond.calculateMatching(graph);
+	const LargeVector<NodeID>& baseMates = edmond.mates();
+
+	if(numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<std::size_t> sizes(queries.size());
+	std::atomic<std::size_t> next(0);
+	std::vector<std::thread> threads;
+
+	for(unsigned int t = 0; t < numThreads; ++t)
+	{
+		threads.emplace_back([&]() {
+			SubgraphMatching matching(graph, &baseMates);
+
+			// The masks are built once per thread and only the entries of
+			// each query are set and reset, so a query costs O(size of the
+			// query) on top of the matching instead of O(n+m).
+			std::vector<bool> removedNodes(graph.numNodes(), false);
+			EdgeMask<Graph> removedEdges(graph);
+
+			std::size_t i;
+			while((i = next++) < queries.size())
+			{
+				for(NodeID v : queries[i].nodes)
+					removedNodes[v] = true;
+
+				for(const Graph::Edge& e : queries[i].edges)
+					removedEdges.remove(e.first, e.second);
+
+				sizes[i] = matching.calculateMatching(&removedNodes, &removedEdges);
+
+				for(NodeID v : queries[i].nodes)
+					removedNodes[v] = false;
+				removedEdges.clear();
+			}
+		});
+	}
+
+	for(std::thread& thread : threads)
+		thread.join();
+
+	for(std::size_t size : sizes)
+		printf("%lu\n", size);
+
+	return 0;
+}
+
+/**
+ * Parse the value @a str of command line option @a option into @a value.
+ * Prints an error and returns false if @a str is not a decimal number in
+ * [@a min, @a max].
+ **/
+static bool parseCount(const char* option, const char* str,
+	unsigned long min, unsigned long max, unsigned int* value)
+{
+	char* endptr = 0;
+	errno = 0;
+	unsigned long v = strtoul(str, &endptr, 10);
 
-	std::ifstream input(argv[1]);
-	if(input.bad())
+	// strtoul() accepts a sign and leading whitespace, we do not
+	if(!isdigit((unsigned char)str[0]) || *endptr != 0 || errno == ERANGE || v < min || v > max)
+	{
+		fprintf(stderr, "Invalid value '%s' for %s, expected a number from %lu to %lu\n",
+			str, option, min, max);
+		return false;
+	}
+
+	*value = v;
+	return true;
+}
+
+/**
+ * Open the input file @a path (see CompressedInput::open()). Prints an
+ * error and returns null on failure.
+ **/
+static std::unique_ptr<std::istream> openInput(const char* path)
+{
+	std::unique_ptr<std::istream> file;
+	try
+	{
+		file = CompressedInput::open(path);
+	}
+	catch(Graph::LoadError& e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+		return std::unique_ptr<std::istream>();
+	}
+
+	if(!*file)
 	{
 		perror("Could not open input file");
+		return std::unique_ptr<std::istream>();
+	}
+
+	return file;
+}
+
+static void usage()
+{
+	fprintf(stderr,
+		"Usage: edmonds [options] <input graph file>\n"
+		"       edmonds --server <socket> [--threads N] [--cache N]\n"
+		"\n"
+		"Use '-' as input file to read from stdin. DIMAC, Matrix Market and\n"
+		"SNAP edge lists are detected automatically, METIS files by their\n"
+		"extension (.graph, .metis). Binary CSR files written by --write-csr\n"
+		"are detected and mapped into memory.\n"
+		"\n"
+		"Options:\n"
+		"  --format f      Input format: auto (default), dimac, metis, mtx,\n"
+		"                  snap, snap0 or snap1 (SNAP with 0/1-based IDs)\n"
+		"  --approx eps    Calculate an approximate matching by only searching\n"
+		"                  for augmenting paths up to length ~2/eps\n"
+		"                  (heuristic, typically within (1-eps) of the\n"
+		"                  maximum, but not guaranteed)\n"
+		"  --interleave N  Keep N neighbor scans in flight to overlap their\n"
+		"                  cache misses (1-256, default: 1, try 8 on large\n"
+		"                  graphs)\n"
+		"  --online-greedy Build a greedy matching in input order while\n"
+		"                  loading, instead of by degree afterwards\n"
+		"  --max-memory s  Memory budget, e.g. 16G. The peak usage is\n"
+		"                  estimated from the DIMAC header, a compact graph\n"
+		"                  representation is chosen if necessary. Fails\n"
+		"                  right away if the graph does not fit.\n"
+		"  --memory-stats  Print the memory usage of each data structure\n"
+		"  --sparsify k    Solve on a subgraph with k random edges per vertex\n"
+		"                  first, then certify the result on the full graph\n"
+		"                  (for dense graphs)\n"
+		"  --stream        Process the edges as a stream with O(n) memory\n"
+		"                  instead of loading the graph (approximate,\n"
+		"                  DIMAC input only)\n"
+		"  --passes N      Number of improvement passes over the input in\n"
+		"                  streaming mode (default: 2)\n"
+		"  --size-only     Only calculate the size of a maximum matching\n"
+		"                  (randomized, via the rank of the Tutte matrix,\n"
+		"                  needs 4n^2 bytes, checked against --max-memory\n"
+		"                  or the physical memory)\n"
+		"  --repetitions N Number of random Tutte matrices in --size-only\n"
+		"                  mode (default: 2). The error probability is at\n"
+		"                  most (n/2^31)^N.\n"
+		"  --threads N     Number of worker threads\n"
+		"  --weighted      Calculate a 1/2-approximate maximum weight matching\n"
+		"                  (weights from 'e v w weight' lines, default 1)\n"
+		"  --rounds N      Number of local search rounds improving the\n"
+		"                  weighted matching (default: 0)\n"
+		"  --queries file  Calculate the matching size of each subgraph given\n"
+		"                  by a line in file, e.g. 'v 3 v 7 e 1 2' removes\n"
+		"                  nodes 3 and 7 and edge {1,2}. Queries run in\n"
+		"                  parallel.\n"
+		"  --write-csr out Convert the input into a binary CSR file, which can\n"
+		"                  be memory-mapped instead of parsed\n"
+		"  --hugepages m   Use huge pages for large arrays (sparse graphs are\n"
+		"                  then stored as CSR arrays): none (default),\n"
+		"                  thp (transparent) or explicit (MAP_HUGETLB)\n"
+		"  --numa m        NUMA placement of large arrays: default (first\n"
+		"                  touch), interleave or local\n"
+		"  --checkpoint f  Periodically save the matching to file f\n"
+		"  --checkpoint-interval s\n"
+		"                  Seconds between checkpoints (default: 300)\n"
+		"  --resume        Continue from the --checkpoint file if it exists\n"
+		"  --server path   Serve matching requests on the Unix domain socket\n"
+		"                  path (see edmonds-client)\n"
+		"  --cache N       Number of graphs kept in memory in server mode\n"
+		"                  (default: 8)\n"
+	);
+}
+
+int main(int argc, char** argv)
+{
+	const char* inputFile = 0;
+	formats::Format format = formats::AUTO;
+	double approx = 0.0;
+	bool streaming = false;
+	bool onlineGreedy = false;
+	std::size_t maxMemory = 0;
+	bool memoryStats = false;
+	unsigned int sparsify = 0;
+	unsigned int passes = 2;
+	bool sizeOnly = false;
+	bool weighted = false;
+	unsigned int rounds = 0;
+	unsigned int repetitions = 2;
+	unsigned int threads = 0;
+	const char* serverSocket = 0;
+	unsigned int cacheSize = 8;
+	const char* queryFile = 0;
+	const char* csrFile = 0;
+	SolveOptions options;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h"))
+		{
+			usage();
+			return 1;
+		}
+		else if(!strcmp(argv[i], "--format") && i+1 < argc)
+		{
+			if(!formats::fromName(argv[++i], &format))
+			{
+				fprintf(stderr, "Invalid input format '%s'\n", argv[i]);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--approx") && i+1 < argc)
+		{
+			char* endptr = 0;
+			approx = strtod(argv[++i], &endptr);
+			if(*endptr != 0 || !(approx > 0.0 && approx < 1.0))
+			{
+				fprintf(stderr, "Invalid approximation factor '%s', expected 0 < eps < 1\n", argv[i]);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--interleave") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 1, 256, &options.interleave))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--online-greedy"))
+			onlineGreedy = true;
+		else if(!strcmp(argv[i], "--max-memory") && i+1 < argc)
+		{
+			maxMemory = memory::parseSize(argv[++i]);
+			if(maxMemory == 0)
+			{
+				fprintf(stderr, "Invalid memory size '%s', expected e.g. 512M or 16G\n", argv[i]);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--memory-stats"))
+			memoryStats = true;
+		else if(!strcmp(argv[i], "--sparsify") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 1, UINT_MAX, &sparsify))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--stream"))
+			streaming = true;
+		else if(!strcmp(argv[i], "--passes") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 0, UINT_MAX, &passes))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--size-only"))
+			sizeOnly = true;
+		else if(!strcmp(argv[i], "--repetitions") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 1, UINT_MAX, &repetitions))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--threads") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 1, 4096, &threads))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--weighted"))
+			weighted = true;
+		else if(!strcmp(argv[i], "--rounds") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 0, UINT_MAX, &rounds))
+				return 1;
+			i++;
+		}
+		else if(!strcmp(argv[i], "--queries") && i+1 < argc)
+			queryFile = argv[++i];
+		else if(!strcmp(argv[i], "--write-csr") && i+1 < argc)
+			csrFile = argv[++i];
+		else if(!strcmp(argv[i], "--hugepages") && i+1 < argc)
+		{
+			const char* mode = argv[++i];
+			if(!strcmp(mode, "none"))
+				memory::setHugePages(memory::HUGEPAGES_NONE);
+			else if(!strcmp(mode, "thp"))
+				memory::setHugePages(memory::HUGEPAGES_TRANSPARENT);
+			else if(!strcmp(mode, "explicit"))
+				memory::setHugePages(memory::HUGEPAGES_EXPLICIT);
+			else
+			{
+				fprintf(stderr, "Invalid huge page mode '%s'\n", mode);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--numa") && i+1 < argc)
+		{
+			const char* mode = argv[++i];
+			if(!strcmp(mode, "default"))
+				memory::setPlacement(memory::PLACEMENT_DEFAULT);
+			else if(!strcmp(mode, "interleave"))
+				memory::setPlacement(memory::PLACEMENT_INTERLEAVE);
+			else if(!strcmp(mode, "local"))
+				memory::setPlacement(memory::PLACEMENT_LOCAL);
+			else
+			{
+				fprintf(stderr, "Invalid NUMA placement '%s'\n", mode);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--checkpoint") && i+1 < argc)
+			options.checkpoint = argv[++i];
+		else if(!strcmp(argv[i], "--checkpoint-interval") && i+1 < argc)
+		{
+			char* endptr = 0;
+			options.checkpointInterval = strtod(argv[++i], &endptr);
+			if(*endptr != 0 || !(options.checkpointInterval > 0.0))
+			{
+				fprintf(stderr, "Invalid checkpoint interval '%s', expected seconds > 0\n", argv[i]);
+				return 1;
+			}
+		}
+		else if(!strcmp(argv[i], "--resume"))
+			options.resume = true;
+		else if(!strcmp(argv[i], "--server") && i+1 < argc)
+			serverSocket = argv[++i];
+		else if(!strcmp(argv[i], "--cache") && i+1 < argc)
+		{
+			if(!parseCount(argv[i], argv[i+1], 0, UINT_MAX, &cacheSize))
+				return 1;
+			i++;
+		}
+		else if((argv[i][0] == '-' && argv[i][1] != 0) || inputFile)
+		{
+			usage();
+			return 1;
+		}
+		else
+			inputFile = argv[i];
+	}
+
+	if(serverSocket && !inputFile)
+	{
+		if(threads == 0)
+			threads = std::thread::hardware_concurrency();
+
+		MatchingServer server(threads, cacheSize);
+		return server.run(serverSocket);
+	}
+
+	if(!inputFile || serverSocket)
+	{
+		usage();
 		return 1;
 	}
 
-	graph.loadDIMAC(input);
+	// Without augmenting paths of length <= 2k+1, (1 - 1/(k+1)) >= 1 - eps
+	// <=> k >= 1/eps - 1. The truncated search only approximates that.
+	if(approx != 0.0)
+		options.depthLimit = std::max(1.0, ceil(1.0 / approx - 1.0));
+	options.threads = threads;
 
-	EdmondsCardinalityMatching edmond;
+	if(options.resume && !options.checkpoint)
+	{
+		fprintf(stderr, "--resume needs a --checkpoint file\n");
+		return 1;
+	}
+
+	// The budget is only checked for the matching computation (and for
+	// --write-csr), the other modes have their own memory requirements.
+	if(maxMemory && (streaming || queryFile || weighted || sparsify))
+	{
+		fprintf(stderr, "--max-memory is not supported in this mode\n");
+		return 1;
+	}
+
+	MemoryUsage memoryUsage;
+	if(memoryStats)
+		options.memory = &memoryUsage;
+
+	if(strcmp(inputFile, "-") != 0 && MappedGraph::isMappedGraph(inputFile))
+	{
+		if(streaming || sizeOnly || queryFile || csrFile || weighted || sparsify)
+		{
+			fprintf(stderr, "This mode is not supported for binary CSR input\n");
+			return 1;
+		}
+
+		MappedGraph mapped;
+		try
+		{
+			mapped.open(inputFile);
+		}
+		catch(Graph::LoadError& e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			return 1;
+		}
+
+		// The mapped file is backed by the page cache, only the solver
+		// state counts
+		NodeID numNodes = mapped.is64Bit() ? mapped.view64().numNodes() : mapped.view32().numNodes();
+		if(maxMemory)
+		{
+			MemoryUsage estimate;
+			estimateSolveMemory(numNodes, threads, &estimate);
+			if(estimate.total() > maxMemory)
+			{
+				fprintf(stderr, "Estimated memory usage:\n");
+				estimate.print(stderr);
+				fprintf(stderr, "Graph with %lu nodes needs about %s, which exceeds --max-memory %s\n",
+					numNodes, memory::formatSize(estimate.total()).c_str(),
+					memory::formatSize(maxMemory).c_str()
+				);
+				return 1;
+			}
+		}
+
+		if(mapped.is64Bit())
+			solve<BasicEdmondsMatching<CSRGraph<uint64_t>>>(mapped.view64(), options);
+		else
+			solve<BasicEdmondsMatching<CSRGraph<uint32_t>>>(mapped.view32(), options);
+
+		if(memoryStats)
+			printMemoryUsage(memoryUsage);
+
+		return 0;
+	}
+
+	// METIS files cannot be told apart from small edge lists reliably, so
+	// their format comes from the command line or the file extension
+	if(format == formats::AUTO)
+		format = formats::fromExtension(inputFile);
+
+	if(streaming && format != formats::AUTO && format != formats::DIMAC)
+	{
+		fprintf(stderr, "--stream only supports DIMAC input\n");
+		return 1;
+	}
+
+	// Compressed files are decompressed on the fly
+	std::unique_ptr<std::istream> file;
+	std::istream* input = &std::cin;
+	if(strcmp(inputFile, "-") != 0)
+	{
+		file = openInput(inputFile);
+		if(!file)
+			return 1;
+		input = file.get();
+	}
+
+	if(streaming)
+	{
+		if(input == &std::cin && passes != 0)
+		{
+			fprintf(stderr, "Warning: Cannot rewind stdin, doing a single pass\n");
+			passes = 0;
+		}
+
+		StreamingMatching stream;
+		for(unsigned int i = 0; i <= passes; ++i)
+		{
+			// Reopen instead of seeking, which also works for compressed
+			// input
+			if(i != 0)
+			{
+				file = openInput(inputFile);
+				if(!file)
+					return 1;
+				input = file.get();
+			}
+
+			std::size_t added;
+			try
+			{
+				added = stream.pass(*input);
+			}
+			catch(Graph::LoadError& e)
+			{
+				fprintf(stderr, "%s\n", e.what());
+				return 1;
+			}
+
+			fprintf(stderr, "Pass %u: matching size %lu\n", i+1, stream.size());
+
+			// No improvement -> further passes will not find anything either
+			if(i != 0 && added == 0)
+				break;
+		}
+
+		writeMatching(stream.mates().data(), stream.numNodes(), stream.size(), threads);
+		return 0;
+	}
+
+	if(weighted)
+	{
+		WeightedGraph graph;
+		try
+		{
+			graph.load(*input, format);
+		}
+		catch(Graph::LoadError& e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			return 1;
+		}
+
+		WeightedMatching matching;
+		matching.setRounds(rounds);
+		if(threads != 0)
+			matching.setThreads(threads);
+
+		auto start = std::chrono::steady_clock::now();
+		std::size_t size = matching.calculateMatching(graph);
+		auto end = std::chrono::steady_clock::now();
+
+		writeMatching(matching.mates().data(), graph.numNodes(), size, threads);
+
+		fprintf(stderr, "Weighted matching: size %lu, weight %.10g, %.1f ms\n",
+			size, matching.weight(),
+			std::chrono::duration<double, std::milli>(end - start).count()
+		);
+		return 0;
+	}
+
+	if(queryFile)
+	{
+		Graph graph;
+		try
+		{
+			graph.load(*input, format);
+		}
+		catch(Graph::LoadError& e)
+		{
+			fprintf(stderr, "%s\n", e.what());
+			return 1;
+		}
+
+		std::ifstream queries(queryFile);
+		if(!queries.is_open())
+		{
+			perror("Could not open query file");
+			return 1;
+		}
+
+		return runQueries(graph, queries, threads);
+	}
+
+	// Choose the graph representation based on the density given in the
+	// header (and the memory budget). The graph is built while the parser
+	// thread reads ahead.
+	GraphLoader loader;
+	loader.matchWhileLoading = onlineGreedy && !csrFile && !sizeOnly;
+	loader.maxMemory = sizeOnly ? 0 : maxMemory; // checked for the Tutte matrix below
+	loader.purpose = csrFile ? GraphLoader::WRITE_CSR : GraphLoader::SOLVE;
+	loader.outputThreads = threads;
+	loader.flatArrays = (memory::hugePages() != memory::HUGEPAGES_NONE
+		|| memory::placement() != memory::PLACEMENT_DEFAULT) && !sizeOnly && !sparsify;
+	try
+	{
+		parseGraphPipelined(*input, loader, threads, format);
+		loader.finish();
+	}
+	catch(Graph::LoadError& e)
+	{
+		fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
 
-	Graph matching;
-	edmond.calculateMatching(graph, matching);
+	if(loader.maxMemory)
+	{
+		fprintf(stderr, "Using %s, estimated peak memory usage %s (limit %s)\n",
+			GraphLoader::name(loader.representation),
+			memory::formatSize(loader.estimatedPeak).c_str(),
+			memory::formatSize(maxMemory).c_str()
+		);
+	}
+
+	if(memoryStats)
+		loader.memoryUsage(&memoryUsage);
+
+	if(loader.matchWhileLoading)
+		options.initialMates = &loader.greedy.mates();
+	options.threads = loader.outputThreads;
+
+	if(csrFile)
+	{
+		bool ok = false;
+		switch(loader.representation)
+		{
+			case GraphLoader::GRAPH: ok = MappedGraph::write(loader.graph, csrFile); break;
+			case GraphLoader::DENSE: ok = MappedGraph::write(loader.denseGraph, csrFile); break;
+			case GraphLoader::CSR32: ok = MappedGraph::write(loader.csr32.graph(), csrFile); break;
+			case GraphLoader::CSR64: ok = MappedGraph::write(loader.csr64.graph(), csrFile); break;
+		}
+
+		if(!ok)
+		{
+			perror("Could not write CSR file");
+			return 1;
+		}
+
+		if(memoryStats)
+			printMemoryUsage(memoryUsage);
+
+		return 0;
+	}
+
+	if(sizeOnly)
+	{
+		NodeID numNodes = (loader.representation == GraphLoader::DENSE)
+			? loader.denseGraph.numNodes() : loader.graph.numNodes();
+
+		// The dense n x n matrix is by far the largest part. Refuse before
+		// allocating it instead of swapping or running out of memory.
+		MemoryUsage estimate;
+		TutteMatchingNumber::estimateMemory(numNodes, &estimate);
+		std::size_t limit = maxMemory ? maxMemory : memory::physicalMemory();
+		if(limit != 0 && estimate.total() > limit)
+		{
+			fprintf(stderr, "Tutte matrix for %lu nodes needs %s, which exceeds %s %s\n",
+				numNodes, memory::formatSize(estimate.total()).c_str(),
+				maxMemory ? "--max-memory" : "the physical memory",
+				memory::formatSize(limit).c_str()
+			);
+			return 1;
+		}
+
+		TutteMatchingNumber tutte;
+		tutte.setRepetitions(repetitions);
+		if(threads != 0)
+			tutte.setThreads(threads);
+
+		std::size_t size;
+		if(loader.representation == GraphLoader::DENSE)
+			size = tutte.calculate(loader.denseGraph);
+		else
+			size = tutte.calculate(loader.graph);
+
+		printf("%lu\n", size);
+		return 0;
+	}
+
+	if(sparsify)
+	{
+		SparsifiedMatching matching;
+		matching.setEdgesPerVertex(sparsify);
+
+		auto start = std::chrono::steady_clock::now();
+		std::size_t size;
+		NodeID numNodes;
+		std::size_t numEdges;
+		if(loader.representation == GraphLoader::DENSE)
+		{
+			size = matching.calculateMatching(loader.denseGraph);
+			numNodes = loader.denseGraph.numNodes();
+			numEdges = loader.denseGraph.numEdges();
+		}
+		else
+		{
+			size = matching.calculateMatching(loader.graph);
+			numNodes = loader.graph.numNodes();
+			numEdges = loader.graph.numEdges();
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		writeMatching(matching.mates().data(), numNodes, size, threads);
+
+		fprintf(stderr, "Sparsified matching: size %lu, %u rounds, subgraph with %lu of %lu edges, "
+			"%.1f%% of the adjacency entries examined, %.1f ms\n",
+			size, matching.rounds(), matching.subgraphEdges(), numEdges,
+			numEdges ? 50.0 * matching.edgesTouched() / numEdges : 0.0,
+			std::chrono::duration<double, std::milli>(end - start).count()
+		);
+		return 0;
+	}
+
+	switch(loader.representation)
+	{
+		case GraphLoader::GRAPH:
+			solve<EdmondsCardinalityMatching>(loader.graph, options);
+			break;
+		case GraphLoader::DENSE:
+			solve<DenseEdmondsMatching>(loader.denseGraph, options);
+			break;
+		case GraphLoader::CSR32:
+			solve<BasicEdmondsMatching<CSRGraph<uint32_t>>>(loader.csr32.graph(), options);
+			break;
+		case GraphLoader::CSR64:
+			solve<BasicEdmondsMatching<CSRGraph<uint64_t>>>(loader.csr64.graph(), options);
+			break;
+	}
 
-	matching.toDIMAC(std::cout);
+	if(memoryStats)
+		printMemoryUsage(memoryUsage);
 
 	return 0;
 }
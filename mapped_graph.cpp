@@ -0,0 +1,191 @@
+// Graph in binary CSR format, memory-mapped from a file
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "mapped_graph.h"
+#include "dense_graph.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fstream>
+
+const char MappedGraph::Magic[8] = {'E', 'D', 'M', 'C', 'S', 'R', '1', 0};
+
+MappedGraph::MappedGraph()
+ : m_data(0)
+ , m_size(0)
+ , m_nodeCount(0)
+ , m_numEntries(0)
+ , m_indexSize(0)
+{
+}
+
+MappedGraph::~MappedGraph()
+{
+	close();
+}
+
+void MappedGraph::open(const std::string& path)
+{
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw Graph::LoadError("Could not open " + path);
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(Header))
+	{
+		::close(fd);
+		throw Graph::LoadError("Binary graph file is too small");
+	}
+
+	void* data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if(data == MAP_FAILED)
+		throw Graph::LoadError("Could not map " + path);
+
+	m_data = data;
+	m_size = st.st_size;
+
+	const Header* header = reinterpret_cast<const Header*>(m_data);
+	if(memcmp(header->magic, Magic, sizeof(Magic)) != 0)
+	{
+		close();
+		throw Graph::LoadError("Invalid binary graph file (wrong magic)");
+	}
+
+	m_nodeCount = header->numNodes;
+	m_numEntries = header->numEntries;
+	m_indexSize = header->indexSize;
+
+	if(m_indexSize != 4 && m_indexSize != 8)
+	{
+		close();
+		throw Graph::LoadError("Invalid binary graph file (bad index size)");
+	}
+
+	// The header values are untrusted, so compare them against the number
+	// of indices in the file instead of multiplying them out (overflow).
+	std::size_t numIndices = (m_size - sizeof(Header)) / m_indexSize;
+	if((m_size - sizeof(Header)) % m_indexSize != 0
+		|| m_nodeCount >= numIndices
+		|| m_numEntries != numIndices - (m_nodeCount + 1))
+	{
+		close();
+		throw Graph::LoadError("Invalid binary graph file (wrong size)");
+	}
+
+	// Check the offsets before isValid() follows them into the neighbors
+	bool valid = is64Bit()
+		? (view64().hasValidOffsets(m_numEntries) && view64().isValid())
+		: (view32().hasValidOffsets(m_numEntries) && view32().isValid());
+	if(!valid)
+	{
+		close();
+		throw Graph::LoadError("Invalid binary graph file (bad CSR data)");
+	}
+}
+
+void MappedGraph::close()
+{
+	if(m_data)
+		munmap(m_data, m_size);
+
+	m_data = 0;
+	m_size = 0;
+}
+
+template<class Index>
+CSRGraph<Index> MappedGraph::view() const
+{
+	const char* data = reinterpret_cast<const char*>(m_data) + sizeof(Header);
+	const Index* offsets = reinterpret_cast<const Index*>(data);
+
+	return CSRGraph<Index>(m_nodeCount, offsets, offsets + m_nodeCount + 1);
+}
+
+CSRGraph<uint32_t> MappedGraph::view32() const
+{
+	return view<uint32_t>();
+}
+
+CSRGraph<uint64_t> MappedGraph::view64() const
+{
+	return view<uint64_t>();
+}
+
+bool MappedGraph::isMappedGraph(const std::string& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+
+	char magic[sizeof(Magic)];
+	if(!stream.read(magic, sizeof(magic)))
+		return false;
+
+	return memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+namespace
+{
+	template<class Index, class GraphT>
+	bool writeArrays(std::ofstream& stream, const GraphT& graph)
+	{
+		std::vector<Index> buffer;
+		buffer.reserve(graph.numNodes() + 1);
+
+		Index offset = 0;
+		buffer.push_back(offset);
+		for(NodeID v = 0; v < graph.numNodes(); ++v)
+		{
+			offset += graph.degree(v);
+			buffer.push_back(offset);
+		}
+		stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Index));
+
+		for(NodeID v = 0; v < graph.numNodes(); ++v)
+		{
+			buffer.clear();
+			for(NodeID w : graph.neighbors(v))
+				buffer.push_back(w);
+			stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Index));
+		}
+
+		return stream.good();
+	}
+}
+
+template<class GraphT>
+bool MappedGraph::write(const GraphT& graph, const std::string& path)
+{
+	std::size_t numEntries = 0;
+	for(NodeID v = 0; v < graph.numNodes(); ++v)
+		numEntries += graph.degree(v);
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, Magic, sizeof(Magic));
+	header.numNodes = graph.numNodes();
+	header.numEntries = numEntries;
+	header.indexSize = (numEntries < 0xffffffffu && graph.numNodes() < 0xffffffffu) ? 4 : 8;
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if(!stream.is_open())
+		return false;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	if(header.indexSize == 4)
+		return writeArrays<uint32_t>(stream, graph);
+	else
+		return writeArrays<uint64_t>(stream, graph);
+}
+
+template bool MappedGraph::write(const Graph& graph, const std::string& path);
+template bool MappedGraph::write(const DenseGraph& graph, const std::string& path);
+template bool MappedGraph::write(const CSRGraph<uint32_t>& graph, const std::string& path);
+template bool MappedGraph::write(const CSRGraph<uint64_t>& graph, const std::string& path);
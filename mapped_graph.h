@@ -0,0 +1,89 @@
+// Graph in binary CSR format, memory-mapped from a file
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef MAPPED_GRAPH_H
+#define MAPPED_GRAPH_H
+
+#include "graph.h"
+#include "csr_graph.h"
+
+#include <stdint.h>
+
+#include <string>
+
+/**
+ * Graph stored in a binary CSR file, which is mapped into memory instead
+ * of being parsed. The file layout is (host byte order):
+ *
+ * @code
+ *   char     magic[8];            // "EDMCSR1\0"
+ *   uint64_t numNodes;
+ *   uint64_t numEntries;          // number of adjacency entries (2m)
+ *   uint32_t indexSize;           // 4 or 8
+ *   uint32_t reserved;
+ *   Index    offsets[numNodes+1]; // Index is uint32_t or uint64_t
+ *   Index    neighbors[numEntries];
+ * @endcode
+ *
+ * Use write() to create such a file.
+ **/
+class MappedGraph
+{
+public:
+	MappedGraph();
+	~MappedGraph();
+
+	/**
+	 * Map the file @a path.
+	 *
+	 * @throw Graph::LoadError if the file cannot be mapped or is invalid
+	 **/
+	void open(const std::string& path);
+
+	//! Unmap the file
+	void close();
+
+	//! Does the file use 64-bit indices?
+	bool is64Bit() const
+	{ return m_indexSize == 8; }
+
+	//! CSR view on the mapped data (only valid if !is64Bit())
+	CSRGraph<uint32_t> view32() const;
+
+	//! CSR view on the mapped data (only valid if is64Bit())
+	CSRGraph<uint64_t> view64() const;
+
+	//! Check whether @a path starts with the MappedGraph magic
+	static bool isMappedGraph(const std::string& path);
+
+	/**
+	 * Write @a graph into the binary CSR file @a path. 64-bit indices are
+	 * used only if necessary.
+	 *
+	 * @return false on error (errno is set)
+	 **/
+	template<class GraphT>
+	static bool write(const GraphT& graph, const std::string& path);
+private:
+	struct Header
+	{
+		char magic[8];
+		uint64_t numNodes;
+		uint64_t numEntries;
+		uint32_t indexSize;
+		uint32_t reserved;
+	};
+
+	static const char Magic[8];
+
+	template<class Index>
+	CSRGraph<Index> view() const;
+
+	void* m_data;
+	std::size_t m_size;
+	NodeID m_nodeCount;
+	std::size_t m_numEntries;
+	uint32_t m_indexSize;
+};
+
+#endif
@@ -0,0 +1,214 @@
+// Subgraph view hiding nodes and edges of a graph
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef MASKED_GRAPH_H
+#define MASKED_GRAPH_H
+
+#include "graph.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Set of removed edges of a graph. Edges are stored as bits per adjacency
+ * list entry, so that a MaskedGraph can skip them in O(1).
+ **/
+template<class GraphT>
+class EdgeMask
+{
+public:
+	explicit EdgeMask(const GraphT& graph)
+	 : m_graph(&graph)
+	 , m_offsets(graph.numNodes() + 1, 0)
+	{
+		for(NodeID v = 0; v < graph.numNodes(); ++v)
+			m_offsets[v+1] = m_offsets[v] + graph.degree(v);
+
+		m_removed.resize(m_offsets.back(), false);
+	}
+
+	/**
+	 * Remove the edge {v,w} (including parallel edges).
+	 *
+	 * Runtime: O(deg(v) + deg(w))
+	 **/
+	void remove(NodeID v, NodeID w)
+	{
+		mark(v, w, true);
+		mark(w, v, true);
+		m_edges.emplace_back(v, w);
+	}
+
+	/**
+	 * Restore all removed edges, so that the mask can be reused without
+	 * rebuilding it.
+	 *
+	 * Runtime: O(deg(v) + deg(w)) per removed edge {v,w}
+	 **/
+	void clear()
+	{
+		for(const Graph::Edge& e : m_edges)
+		{
+			mark(e.first, e.second, false);
+			mark(e.second, e.first, false);
+		}
+		m_edges.clear();
+	}
+
+	//! Is the adjacency list entry @a slot (see offset()) removed?
+	bool isRemoved(std::size_t slot) const
+	{ return m_removed[slot]; }
+
+	//! Index of the first adjacency list entry of @a v
+	std::size_t offset(NodeID v) const
+	{ return m_offsets[v]; }
+
+	//! List of edges passed to remove()
+	const std::vector<Graph::Edge>& edges() const
+	{ return m_edges; }
+private:
+	void mark(NodeID v, NodeID w, bool removed)
+	{
+		std::size_t slot = m_offsets[v];
+		for(NodeID u : m_graph->neighbors(v))
+		{
+			if(u == w)
+				m_removed[slot] = removed;
+			slot++;
+		}
+	}
+
+	const GraphT* m_graph;
+	std::vector<std::size_t> m_offsets;
+	std::vector<bool> m_removed;
+	std::vector<Graph::Edge> m_edges;
+};
+
+/**
+ * Read-only view on the subgraph of @a GraphT without the nodes in
+ * @a removedNodes and the edges in @a removedEdges (both may be null).
+ * Removed nodes stay in the graph as isolated nodes, so that NodeIDs are
+ * the same as in the base graph.
+ *
+ * The view does not copy anything, so many views (e.g. in different
+ * threads) can share one base graph.
+ **/
+template<class GraphT>
+class MaskedGraph
+{
+public:
+	typedef decltype(std::declval<const GraphT&>().neighbors(0).begin()) BaseIterator;
+
+	//! Iterates over the adjacent nodes which are not masked out
+	class NeighborIterator
+	{
+	public:
+		NeighborIterator(const MaskedGraph* graph, BaseIterator it, BaseIterator end, std::size_t slot)
+		 : m_graph(graph), m_it(it), m_end(end), m_slot(slot)
+		{ skipRemoved(); }
+
+		NodeID operator*() const
+		{ return *m_it; }
+
+		NeighborIterator& operator++()
+		{
+			++m_it;
+			++m_slot;
+			skipRemoved();
+			return *this;
+		}
+
+		bool operator!=(const NeighborIterator& other) const
+		{ return m_it != other.m_it; }
+	private:
+		void skipRemoved()
+		{
+			while(m_it != m_end && m_graph->isRemoved(*m_it, m_slot))
+			{
+				++m_it;
+				++m_slot;
+			}
+		}
+
+		const MaskedGraph* m_graph;
+		BaseIterator m_it;
+		BaseIterator m_end;
+		std::size_t m_slot; //!< index of the adjacency entry (see EdgeMask)
+	};
+
+	//! Range of adjacent nodes, usable in range-based for loops
+	class NeighborRange
+	{
+	public:
+		NeighborRange(const MaskedGraph* graph, NodeID v)
+		 : m_graph(graph), m_v(v)
+		{}
+
+		NeighborIterator begin() const;
+		NeighborIterator end() const;
+	private:
+		const MaskedGraph* m_graph;
+		NodeID m_v;
+	};
+
+	MaskedGraph(const GraphT& base, const std::vector<bool>* removedNodes, const EdgeMask<GraphT>* removedEdges)
+	 : m_base(&base)
+	 , m_removedNodes(removedNodes)
+	 , m_removedEdges(removedEdges)
+	{}
+
+	//! Return number of nodes in the graph (including removed ones)
+	NodeID numNodes() const
+	{ return m_base->numNodes(); }
+
+	//! Is node @a v removed?
+	bool isRemoved(NodeID v) const
+	{ return m_removedNodes && (*m_removedNodes)[v]; }
+
+	//! Return the adjacent nodes of @a v
+	NeighborRange neighbors(NodeID v) const
+	{ return NeighborRange(this, v); }
+
+	/**
+	 * Return the number of adjacent nodes of @a v in the base graph (0 for
+	 * removed nodes). This is an upper bound for the actual degree, which
+	 * would take O(deg(v)) to compute.
+	 **/
+	std::size_t degree(NodeID v) const
+	{ return isRemoved(v) ? 0 : m_base->degree(v); }
+
+	//! The unmasked graph
+	const GraphT& base() const
+	{ return *m_base; }
+private:
+	bool isRemoved(NodeID w, std::size_t slot) const
+	{
+		return isRemoved(w) || (m_removedEdges && m_removedEdges->isRemoved(slot));
+	}
+
+	const GraphT* m_base;
+	const std::vector<bool>* m_removedNodes;
+	const EdgeMask<GraphT>* m_removedEdges;
+};
+
+template<class GraphT>
+typename MaskedGraph<GraphT>::NeighborIterator MaskedGraph<GraphT>::NeighborRange::begin() const
+{
+	auto&& range = m_graph->m_base->neighbors(m_v);
+
+	// Removed nodes have no neighbors
+	if(m_graph->isRemoved(m_v))
+		return NeighborIterator(m_graph, range.end(), range.end(), 0);
+
+	std::size_t slot = m_graph->m_removedEdges ? m_graph->m_removedEdges->offset(m_v) : 0;
+	return NeighborIterator(m_graph, range.begin(), range.end(), slot);
+}
+
+template<class GraphT>
+typename MaskedGraph<GraphT>::NeighborIterator MaskedGraph<GraphT>::NeighborRange::end() const
+{
+	auto&& range = m_graph->m_base->neighbors(m_v);
+	return NeighborIterator(m_graph, range.end(), range.end(), 0);
+}
+
+#endif
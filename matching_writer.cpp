@@ -0,0 +1,179 @@
+// Fast DIMAC output of matchings
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "matching_writer.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Number of nodes formatted by one thread at a time. A chunk produces at
+// most one line per node (the mate may be in a later chunk).
+static const NodeID ChunkSize = 1 << 20;
+
+// Two-digit lookup table: "00" "01" ... "99"
+static const char DigitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+MatchingWriter::MatchingWriter()
+ : m_threads(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+void MatchingWriter::setThreads(unsigned int threads)
+{
+	m_threads = std::max(1u, threads);
+}
+
+char* MatchingWriter::formatUInt(char* dest, uint64_t value)
+{
+	// Determine the number of digits first, so that we can write the
+	// digits backwards without a temporary buffer.
+	unsigned int digits = 1;
+	for(uint64_t v = value; v >= 10; v /= 10)
+		digits++;
+
+	char* end = dest + digits;
+	char* p = end;
+
+	while(value >= 100)
+	{
+		unsigned int pair = (value % 100) * 2;
+		value /= 100;
+		*--p = DigitPairs[pair + 1];
+		*--p = DigitPairs[pair];
+	}
+
+	if(value >= 10)
+	{
+		*--p = DigitPairs[value * 2 + 1];
+		*--p = DigitPairs[value * 2];
+	}
+	else
+		*--p = '0' + value;
+
+	return end;
+}
+
+namespace
+{
+	//! Maximum length of an output line "e v w\n" for @a numNodes nodes
+	std::size_t maxLineSize(NodeID numNodes)
+	{
+		// 1-based IDs are at most numNodes
+		unsigned int digits = 1;
+		for(uint64_t v = numNodes; v >= 10; v /= 10)
+			digits++;
+
+		return 4 + 2 * digits;
+	}
+
+	//! Format the edges of nodes [begin,end) into @a buffer
+	void formatChunk(const NodeID* mates, NodeID numNodes, NodeID begin, NodeID end, std::string* buffer)
+	{
+		buffer->resize((end - begin) * maxLineSize(numNodes));
+
+		char* p = &(*buffer)[0];
+		for(NodeID v = begin; v < end; ++v)
+		{
+			if(mates[v] <= v)
+				continue;
+
+			// DIMAC is 1-based, we are 0-based
+			*p++ = 'e';
+			*p++ = ' ';
+			p = MatchingWriter::formatUInt(p, v + 1);
+			*p++ = ' ';
+			p = MatchingWriter::formatUInt(p, mates[v] + 1);
+			*p++ = '\n';
+		}
+
+		buffer->resize(p - buffer->data());
+	}
+
+	bool writeFull(int fd, const char* data, std::size_t size)
+	{
+		while(size != 0)
+		{
+			ssize_t ret = ::write(fd, data, size);
+			if(ret < 0 && errno == EINTR)
+				continue;
+			if(ret <= 0)
+				return false;
+
+			data += ret;
+			size -= ret;
+		}
+
+		return true;
+	}
+}
+
+std::size_t MatchingWriter::bufferSize(NodeID numNodes) const
+{
+	NodeID numChunks = std::min<NodeID>(m_threads, (numNodes + ChunkSize - 1) / ChunkSize);
+	return numChunks * std::min(numNodes, ChunkSize) * maxLineSize(numNodes);
+}
+
+bool MatchingWriter::write(int fd, const NodeID* mates, NodeID numNodes, std::size_t numEdges)
+{
+	char header[64];
+	char* p = header;
+	memcpy(p, "p edge ", 7);
+	p = formatUInt(p + 7, numNodes);
+	*p++ = ' ';
+	p = formatUInt(p, numEdges);
+	*p++ = '\n';
+
+	if(!writeFull(fd, header, p - header))
+		return false;
+
+	// Format m_threads chunks in parallel, then write them in order
+	std::vector<std::string> buffers(m_threads);
+	for(NodeID round = 0; round < numNodes; round += NodeID(m_threads) * ChunkSize)
+	{
+		std::vector<std::thread> threads;
+		unsigned int numChunks = 0;
+
+		for(unsigned int i = 0; i < m_threads; ++i)
+		{
+			NodeID begin = round + NodeID(i) * ChunkSize;
+			if(begin >= numNodes)
+				break;
+			NodeID end = std::min(begin + ChunkSize, numNodes);
+
+			// Format the first chunk ourselves
+			if(i != 0)
+				threads.emplace_back(formatChunk, mates, numNodes, begin, end, &buffers[i]);
+			numChunks++;
+		}
+
+		formatChunk(mates, numNodes, round, std::min(round + ChunkSize, numNodes), &buffers[0]);
+
+		for(std::thread& thread : threads)
+			thread.join();
+
+		for(unsigned int i = 0; i < numChunks; ++i)
+		{
+			if(!writeFull(fd, buffers[i].data(), buffers[i].size()))
+				return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,46 @@
+// Fast DIMAC output of matchings
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef MATCHING_WRITER_H
+#define MATCHING_WRITER_H
+
+#include "graph.h"
+
+/**
+ * Writes a matching given as mate array directly in DIMAC format, without
+ * building a Graph first.
+ *
+ * Integers are formatted by hand into large buffers, which is much faster
+ * than std::ostream. The node range is split into chunks, which are
+ * formatted in parallel and written in order with few large write() calls.
+ **/
+class MatchingWriter
+{
+public:
+	MatchingWriter();
+
+	//! Number of formatting threads (default: hardware concurrency)
+	void setThreads(unsigned int threads);
+
+	/**
+	 * Write the matching @a mates (v is matched to mates[v], unmatched if
+	 * mates[v] == v) with @a numEdges edges to file descriptor @a fd.
+	 *
+	 * @return false on write error (errno is set)
+	 **/
+	bool write(int fd, const NodeID* mates, NodeID numNodes, std::size_t numEdges);
+
+	//! Maximum size of the formatting buffers of write() for @a numNodes nodes
+	std::size_t bufferSize(NodeID numNodes) const;
+
+	/**
+	 * Format @a value in decimal at @a dest.
+	 *
+	 * @return Pointer behind the last digit
+	 **/
+	static char* formatUInt(char* dest, uint64_t value);
+private:
+	unsigned int m_threads;
+};
+
+#endif
@@ -0,0 +1,113 @@
+// Memory accounting of the data structures
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "memory_usage.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+void MemoryUsage::add(const std::string& name, std::size_t bytes)
+{
+	m_entries.push_back(Entry{name, bytes});
+}
+
+void MemoryUsage::add(const std::string& prefix, const MemoryUsage& other)
+{
+	for(const Entry& e : other.m_entries)
+		add(prefix + e.name, e.bytes);
+}
+
+std::size_t MemoryUsage::total() const
+{
+	std::size_t sum = 0;
+	for(const Entry& e : m_entries)
+		sum += e.bytes;
+	return sum;
+}
+
+void MemoryUsage::print(FILE* out) const
+{
+	print(out, "total", total());
+}
+
+void MemoryUsage::print(FILE* out, const char* label, std::size_t bytes) const
+{
+	for(const Entry& e : m_entries)
+		fprintf(out, "  %-36s %12s\n", e.name.c_str(), memory::formatSize(e.bytes).c_str());
+	fprintf(out, "  %-36s %12s\n", label, memory::formatSize(bytes).c_str());
+}
+
+namespace memory
+{
+
+std::size_t parseSize(const char* str)
+{
+	char* endptr = 0;
+	double value = strtod(str, &endptr);
+	if(endptr == str || !(value > 0.0))
+		return 0;
+
+	double unit = 1.0;
+	switch(*endptr)
+	{
+		case 0: break;
+		case 'k': case 'K': unit = 1024.0; endptr++; break;
+		case 'm': case 'M': unit = 1024.0 * 1024; endptr++; break;
+		case 'g': case 'G': unit = 1024.0 * 1024 * 1024; endptr++; break;
+		case 't': case 'T': unit = 1024.0 * 1024 * 1024 * 1024; endptr++; break;
+		default: return 0;
+	}
+
+	// Allow "16G", "16GB" and "16GiB"
+	if(*endptr == 'i')
+		endptr++;
+	if(*endptr == 'B' || *endptr == 'b')
+		endptr++;
+	if(*endptr != 0)
+		return 0;
+
+	return value * unit;
+}
+
+std::string formatSize(std::size_t bytes)
+{
+	const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+
+	double value = bytes;
+	unsigned int unit = 0;
+	while(value >= 1024.0 && unit < 4)
+	{
+		value /= 1024.0;
+		unit++;
+	}
+
+	char buf[32];
+	if(unit == 0)
+		snprintf(buf, sizeof(buf), "%lu B", bytes);
+	else
+		snprintf(buf, sizeof(buf), "%.1f %s", value, units[unit]);
+	return buf;
+}
+
+std::size_t peakResidentSize()
+{
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	// Linux reports kilobytes
+	return std::size_t(usage.ru_maxrss) * 1024;
+}
+
+std::size_t physicalMemory()
+{
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long pageSize = sysconf(_SC_PAGESIZE);
+	if(pages <= 0 || pageSize <= 0)
+		return 0;
+
+	return std::size_t(pages) * pageSize;
+}
+
+}
@@ -0,0 +1,83 @@
+// Memory accounting of the data structures
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Memory used (or expected to be used) by named data structures, in bytes.
+ *
+ * The data structures add their entries with their memoryUsage() or
+ * estimateMemory() members. Vectors are accounted with their capacity,
+ * nested vectors include the heap blocks of the inner vectors.
+ **/
+class MemoryUsage
+{
+public:
+	struct Entry
+	{
+		std::string name;
+		std::size_t bytes;
+	};
+
+	//! Add @a bytes used by structure @a name
+	void add(const std::string& name, std::size_t bytes);
+
+	//! Add all entries of @a other, prefixing their names with @a prefix
+	void add(const std::string& prefix, const MemoryUsage& other);
+
+	const std::vector<Entry>& entries() const
+	{ return m_entries; }
+
+	//! Sum of all entries
+	std::size_t total() const;
+
+	//! Print one line per entry and the total to @a out
+	void print(FILE* out) const;
+
+	//! Print one line per entry and @a bytes labeled @a label to @a out
+	void print(FILE* out, const char* label, std::size_t bytes) const;
+private:
+	std::vector<Entry> m_entries;
+};
+
+namespace memory
+{
+	//! Bytes allocated by vector @a v
+	template<class T, class A>
+	std::size_t bytes(const std::vector<T, A>& v)
+	{ return v.capacity() * sizeof(T); }
+
+	template<class A>
+	std::size_t bytes(const std::vector<bool, A>& v)
+	{ return v.capacity() / 8; }
+
+	//! Bytes allocated by a vector of vectors, including the inner vectors
+	template<class T, class A, class B>
+	std::size_t bytes(const std::vector<std::vector<T, A>, B>& v)
+	{
+		std::size_t sum = v.capacity() * sizeof(std::vector<T, A>);
+		for(const std::vector<T, A>& inner : v)
+			sum += bytes(inner);
+		return sum;
+	}
+
+	//! Parse a size like "512M", "16G" or "1000000" (bytes), 0 on error
+	std::size_t parseSize(const char* str);
+
+	//! Format @a bytes for humans ("1.5 GiB")
+	std::string formatSize(std::size_t bytes);
+
+	//! Peak resident set size of the process in bytes
+	std::size_t peakResidentSize();
+
+	//! Size of the physical memory in bytes (0 if unknown)
+	std::size_t physicalMemory();
+}
+
+#endif
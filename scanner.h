@@ -0,0 +1,81 @@
+// Fast scanning of text graph formats
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "graph.h"
+
+#include <stdint.h>
+
+/**
+ * Helpers for scanning text in memory ranges [p,end). These are much
+ * faster than strtoul() and sscanf(), which need NUL-terminated strings
+ * and respect the locale.
+ **/
+namespace scanner
+{
+
+//! Is @a c a blank character inside a line?
+inline bool isBlank(char c)
+{ return c == ' ' || c == '\t' || c == '\r'; }
+
+//! Skip blanks
+inline const char* skipBlanks(const char* p, const char* end)
+{
+	while(p != end && isBlank(*p))
+		++p;
+	return p;
+}
+
+//! Skip a token (everything up to the next blank or newline)
+inline const char* skipToken(const char* p, const char* end)
+{
+	while(p != end && !isBlank(*p) && *p != '\n')
+		++p;
+	return p;
+}
+
+//! Return the position behind the next newline, or @a end
+inline const char* nextLine(const char* p, const char* end)
+{
+	while(p != end && *p != '\n')
+		++p;
+	return (p == end) ? end : p + 1;
+}
+
+//! Is the rest of the line at @a p empty?
+inline bool atLineEnd(const char* p, const char* end)
+{
+	p = skipBlanks(p, end);
+	return p == end || *p == '\n';
+}
+
+/**
+ * Parse an unsigned decimal number at @a p and advance @a p behind it.
+ *
+ * @return false if there is no digit at @a p
+ * @throw Graph::LoadError if the number does not fit into 64 bits
+ **/
+inline bool parseUInt(const char*& p, const char* end, uint64_t* value)
+{
+	if(p == end || *p < '0' || *p > '9')
+		return false;
+
+	uint64_t v = 0;
+	while(p != end && *p >= '0' && *p <= '9')
+	{
+		unsigned int digit = *p++ - '0';
+		if(v > (UINT64_MAX - digit) / 10)
+			throw Graph::LoadError("Number out of range");
+
+		v = v * 10 + digit;
+	}
+
+	*value = v;
+	return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,426 @@
+// Persistent matching server
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "server.h"
+#include "server_protocol.h"
+#include "edmonds.h"
+#include "compressed_input.h"
+#include "graph_formats.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <condition_variable>
+#include <queue>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////
+// GRAPH CACHE
+
+void GraphCache::Entry::setFile(const struct stat& st)
+{
+	mtime = st.st_mtim;
+	size = st.st_size;
+	device = st.st_dev;
+	inode = st.st_ino;
+}
+
+bool GraphCache::Entry::isCurrent(const struct stat& st) const
+{
+	// Files replaced by rename() have a new inode, files rewritten in place
+	// within the timestamp granularity usually differ in size.
+	return mtime.tv_sec == st.st_mtim.tv_sec
+		&& mtime.tv_nsec == st.st_mtim.tv_nsec
+		&& size == st.st_size
+		&& device == st.st_dev
+		&& inode == st.st_ino;
+}
+
+GraphCache::GraphCache(std::size_t capacity)
+ : m_capacity(capacity)
+{
+}
+
+std::shared_ptr<const Graph> GraphCache::get(const std::string& path)
+{
+	struct stat st;
+	if(stat(path.c_str(), &st) != 0)
+		throw Graph::LoadError("Could not stat " + path);
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto it = m_index.find(path);
+		if(it != m_index.end())
+		{
+			if(it->second->isCurrent(st))
+			{
+				// Cache hit: move to front
+				m_entries.splice(m_entries.begin(), m_entries, it->second);
+				return it->second->graph;
+			}
+
+			// Stale entry
+			m_entries.erase(it->second);
+			m_index.erase(it);
+		}
+	}
+
+	// Load without holding the lock, so that other requests can proceed
+	std::unique_ptr<std::istream> stream = CompressedInput::open(path.c_str());
+	if(!*stream)
+		throw Graph::LoadError("Could not open " + path);
+
+	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+	graph->load(*stream, formats::fromExtension(path.c_str()));
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// Another thread might have loaded the same graph in the meantime
+	if(m_index.count(path) == 0 && m_capacity != 0)
+	{
+		Entry entry;
+		entry.path = path;
+		entry.setFile(st);
+		entry.graph = graph;
+		m_entries.push_front(entry);
+		m_index[path] = m_entries.begin();
+
+		while(m_entries.size() > m_capacity)
+		{
+			m_index.erase(m_entries.back().path);
+			m_entries.pop_back();
+		}
+	}
+
+	return graph;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SERVER
+
+namespace
+{
+	//! Complete request, read by the poll loop and handed to a worker
+	struct Job
+	{
+		int fd;
+		std::string path;
+	};
+
+	//! Queue of requests, consumed by the workers
+	class JobQueue
+	{
+	public:
+		void push(Job job)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_queue.push(std::move(job));
+			m_cond.notify_one();
+		}
+
+		Job pop()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while(m_queue.empty())
+				m_cond.wait(lock);
+
+			Job job = std::move(m_queue.front());
+			m_queue.pop();
+			return job;
+		}
+	private:
+		std::queue<Job> m_queue;
+		std::mutex m_mutex;
+		std::condition_variable m_cond;
+	};
+
+	/**
+	 * Connection waiting for its next request. The request is read
+	 * without blocking, so that clients sending partial requests (or
+	 * nothing at all) cannot occupy a worker.
+	 **/
+	struct Connection
+	{
+		explicit Connection(int fd)
+		 : fd(fd)
+		{}
+
+		int fd;
+		std::vector<char> buffer; //!< partial request read so far
+	};
+
+	bool sendError(int fd, uint32_t status)
+	{
+		protocol::ReplyHeader reply;
+		reply.magic = protocol::MAGIC;
+		reply.status = status;
+		reply.numNodes = 0;
+		reply.matchingSize = 0;
+		return protocol::writeFull(fd, &reply, sizeof(reply));
+	}
+
+	enum ReadResult
+	{
+		READ_PENDING,  //!< request not complete yet
+		READ_COMPLETE, //!< request complete, see @a path
+		READ_CLOSED    //!< connection closed or invalid request
+	};
+
+	/**
+	 * Read the available bytes of the next request on @a conn without
+	 * blocking. Reads at most up to the end of the request, so pipelined
+	 * requests stay in the socket buffer.
+	 **/
+	ReadResult readRequest(Connection* conn, std::string* path)
+	{
+		const std::size_t headerSize = sizeof(protocol::RequestHeader);
+
+		std::size_t expected = headerSize;
+		if(conn->buffer.size() >= headerSize)
+		{
+			const protocol::RequestHeader* request =
+				reinterpret_cast<const protocol::RequestHeader*>(conn->buffer.data());
+			expected += request->pathLength;
+		}
+
+		std::size_t offset = conn->buffer.size();
+		conn->buffer.resize(expected);
+		ssize_t ret = recv(conn->fd, conn->buffer.data() + offset, expected - offset, MSG_DONTWAIT);
+		if(ret < 0)
+		{
+			conn->buffer.resize(offset);
+			return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? READ_PENDING : READ_CLOSED;
+		}
+		if(ret == 0)
+			return READ_CLOSED;
+
+		conn->buffer.resize(offset + ret);
+		if(conn->buffer.size() < headerSize)
+			return READ_PENDING;
+
+		protocol::RequestHeader request;
+		memcpy(&request, conn->buffer.data(), headerSize);
+
+		if(request.magic != protocol::MAGIC
+			|| request.type != protocol::REQUEST_SOLVE
+			|| request.pathLength > protocol::MAX_PATH_LENGTH)
+		{
+			sendError(conn->fd, protocol::STATUS_BAD_REQUEST);
+			return READ_CLOSED;
+		}
+
+		if(conn->buffer.size() < headerSize + request.pathLength)
+			return READ_PENDING;
+
+		path->assign(conn->buffer.data() + headerSize, request.pathLength);
+		conn->buffer.clear();
+		return READ_COMPLETE;
+	}
+
+	/**
+	 * Solve the request @a path and send the reply on connection @a fd.
+	 * @a edmond and @a mates are the worker's persistent state.
+	 *
+	 * @return false if the connection should be closed
+	 **/
+	bool serveRequest(int fd, const std::string& path, GraphCache& cache,
+		EdmondsCardinalityMatching& edmond, std::vector<uint32_t>& mates)
+	{
+		protocol::ReplyHeader reply;
+		reply.magic = protocol::MAGIC;
+		reply.status = protocol::STATUS_OK;
+
+		try
+		{
+			std::shared_ptr<const Graph> graph = cache.get(path);
+
+			// Node IDs are sent as uint32_t, UNMATCHED must stay distinct
+			if(graph->numNodes() >= protocol::UNMATCHED)
+			{
+				fprintf(stderr, "Graph %s has too many nodes for the protocol\n", path.c_str());
+				return sendError(fd, protocol::STATUS_TOO_LARGE);
+			}
+
+			reply.numNodes = graph->numNodes();
+			reply.matchingSize = edmond.calculateMatching(*graph);
+		}
+		catch(Graph::LoadError& e)
+		{
+			fprintf(stderr, "Could not load graph: %s\n", e.what());
+			return sendError(fd, protocol::STATUS_LOAD_ERROR);
+		}
+		catch(std::exception& e)
+		{
+			fprintf(stderr, "Could not serve request for %s: %s\n", path.c_str(), e.what());
+			return sendError(fd, protocol::STATUS_SERVER_ERROR);
+		}
+
+		const LargeVector<NodeID>& mu = edmond.mates();
+		mates.resize(mu.size());
+		for(NodeID v = 0; v < mu.size(); ++v)
+			mates[v] = (mu[v] == v) ? protocol::UNMATCHED : mu[v];
+
+		return protocol::writeFull(fd, &reply, sizeof(reply))
+			&& protocol::writeFull(fd, mates.data(), mates.size() * sizeof(uint32_t));
+	}
+}
+
+MatchingServer::MatchingServer(unsigned int numWorkers, std::size_t cacheSize)
+ : m_numWorkers(std::max(1u, numWorkers))
+ , m_cache(cacheSize)
+{
+}
+
+int MatchingServer::run(const std::string& path)
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+
+	if(path.length() >= sizeof(addr.sun_path))
+	{
+		fprintf(stderr, "Socket path is too long\n");
+		return 1;
+	}
+	strcpy(addr.sun_path, path.c_str());
+
+	// Clients disconnecting during a reply should not kill the server
+	signal(SIGPIPE, SIG_IGN);
+
+	int serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(serverFd < 0)
+	{
+		perror("Could not create socket");
+		return 1;
+	}
+
+	// Remove stale socket from a previous run
+	unlink(path.c_str());
+
+	if(bind(serverFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+	{
+		perror("Could not bind socket");
+		return 1;
+	}
+
+	if(listen(serverFd, 128) != 0)
+	{
+		perror("Could not listen on socket");
+		return 1;
+	}
+
+	// Workers hand finished connections back through this pipe. Writes of
+	// a single fd are atomic, so no further locking is needed.
+	int returnPipe[2];
+	if(pipe(returnPipe) != 0)
+	{
+		perror("Could not create pipe");
+		return 1;
+	}
+
+	JobQueue queue;
+	std::vector<std::thread> workers;
+	for(unsigned int i = 0; i < m_numWorkers; ++i)
+	{
+		workers.emplace_back([&]() {
+			EdmondsCardinalityMatching edmond;
+			std::vector<uint32_t> mates;
+
+			while(1)
+			{
+				Job job = queue.pop();
+				if(!serveRequest(job.fd, job.path, m_cache, edmond, mates)
+					|| !protocol::writeFull(returnPipe[1], &job.fd, sizeof(job.fd)))
+				{
+					close(job.fd);
+				}
+			}
+		});
+	}
+
+	fprintf(stderr, "Listening on %s with %u workers\n", path.c_str(), m_numWorkers);
+
+	// Connections waiting for (the rest of) their next request
+	std::vector<Connection> idle;
+	std::vector<pollfd> pollFds;
+
+	while(1)
+	{
+		pollFds.clear();
+		pollFds.push_back(pollfd{serverFd, POLLIN, 0});
+		pollFds.push_back(pollfd{returnPipe[0], POLLIN, 0});
+		for(const Connection& conn : idle)
+			pollFds.push_back(pollfd{conn.fd, POLLIN, 0});
+
+		if(poll(pollFds.data(), pollFds.size(), -1) < 0)
+		{
+			if(errno == EINTR)
+				continue;
+
+			perror("Could not poll connections");
+			break;
+		}
+
+		// Read from the readable connections and dispatch complete
+		// requests. idle[j] corresponds to pollFds[j+2].
+		std::size_t numIdle = idle.size();
+		std::size_t kept = 0;
+		for(std::size_t j = 0; j < numIdle; ++j)
+		{
+			ReadResult result = READ_PENDING;
+			std::string request;
+			if(pollFds[j+2].revents != 0)
+				result = readRequest(&idle[j], &request);
+
+			if(result == READ_COMPLETE)
+				queue.push(Job{idle[j].fd, std::move(request)});
+			else if(result == READ_CLOSED)
+				close(idle[j].fd);
+			else
+			{
+				if(kept != j)
+					idle[kept] = std::move(idle[j]);
+				kept++;
+			}
+		}
+		idle.erase(idle.begin() + kept, idle.end());
+
+		if(pollFds[1].revents & POLLIN)
+		{
+			int fds[256];
+			ssize_t bytes = read(returnPipe[0], fds, sizeof(fds));
+			for(ssize_t j = 0; j < bytes / ssize_t(sizeof(int)); ++j)
+				idle.emplace_back(fds[j]);
+		}
+
+		if(pollFds[0].revents & POLLIN)
+		{
+			int fd = accept(serverFd, 0, 0);
+			if(fd < 0)
+			{
+				if(errno == EINTR || errno == ECONNABORTED)
+					continue;
+
+				perror("Could not accept connection");
+				break;
+			}
+
+			idle.emplace_back(fd);
+		}
+	}
+
+	// Workers block forever in pop(), so we cannot join them here.
+	for(std::thread& worker : workers)
+		worker.detach();
+
+	close(serverFd);
+	return 1;
+}
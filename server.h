@@ -0,0 +1,90 @@
+// Persistent matching server
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "graph.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/**
+ * LRU cache of parsed graphs, keyed by file path. A cached graph is
+ * reloaded if the modification time (with nanoseconds), size or inode of
+ * the file changed.
+ *
+ * All methods are thread-safe.
+ **/
+class GraphCache
+{
+public:
+	explicit GraphCache(std::size_t capacity);
+
+	/**
+	 * Return the graph stored at @a path, loading it if necessary. The
+	 * returned graph stays valid even if it is evicted from the cache.
+	 *
+	 * @throw Graph::LoadError if the file cannot be loaded
+	 * @throw std::bad_alloc if the graph does not fit into memory
+	 **/
+	std::shared_ptr<const Graph> get(const std::string& path);
+private:
+	struct Entry
+	{
+		std::string path;
+		struct timespec mtime;
+		off_t size;
+		dev_t device;
+		ino_t inode;
+		std::shared_ptr<const Graph> graph;
+
+		//! Set the file attributes from @a st
+		void setFile(const struct stat& st);
+
+		//! Does the entry still describe the file with status @a st?
+		bool isCurrent(const struct stat& st) const;
+	};
+
+	std::size_t m_capacity;
+
+	//! Cache entries, most recently used first
+	std::list<Entry> m_entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+	std::mutex m_mutex;
+};
+
+/**
+ * Serves matching requests on a Unix domain socket (see server_protocol.h).
+ *
+ * Requests are handled by a fixed pool of worker threads, each of which
+ * keeps its own EdmondsCardinalityMatching instance, so that the solver
+ * arrays are only allocated once. The accepting thread polls all idle
+ * connections and reads their requests without blocking. Only complete
+ * requests are handed to a worker, which sends the reply and hands the
+ * connection back. Thus idle or stalled clients do not occupy workers.
+ **/
+class MatchingServer
+{
+public:
+	MatchingServer(unsigned int numWorkers, std::size_t cacheSize);
+
+	/**
+	 * Listen on the socket @a path and serve requests. Only returns on
+	 * error.
+	 **/
+	int run(const std::string& path);
+private:
+	unsigned int m_numWorkers;
+	GraphCache m_cache;
+};
+
+#endif
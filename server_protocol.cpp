@@ -0,0 +1,77 @@
+// Binary protocol of the matching server
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "server_protocol.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace protocol
+{
+
+bool readFull(int fd, void* data, std::size_t size)
+{
+	char* dest = reinterpret_cast<char*>(data);
+	while(size != 0)
+	{
+		ssize_t ret = ::read(fd, dest, size);
+		if(ret < 0 && errno == EINTR)
+			continue;
+		if(ret <= 0)
+			return false;
+
+		dest += ret;
+		size -= ret;
+	}
+
+	return true;
+}
+
+bool writeFull(int fd, const void* data, std::size_t size)
+{
+	const char* src = reinterpret_cast<const char*>(data);
+	while(size != 0)
+	{
+		ssize_t ret = ::write(fd, src, size);
+		if(ret < 0 && errno == EINTR)
+			continue;
+		if(ret <= 0)
+			return false;
+
+		src += ret;
+		size -= ret;
+	}
+
+	return true;
+}
+
+int connect(const std::string& path)
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+
+	if(path.length() >= sizeof(addr.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+	strcpy(addr.sun_path, path.c_str());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0)
+		return -1;
+
+	if(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+}
@@ -0,0 +1,66 @@
+// Binary protocol of the matching server
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef SERVER_PROTOCOL_H
+#define SERVER_PROTOCOL_H
+
+#include <stdint.h>
+
+#include <string>
+
+/**
+ * The matching server (edmonds --server) listens on a Unix domain socket.
+ * A client can send any number of requests over one connection, each is
+ * answered before the next one is read. All integers are in host byte
+ * order.
+ *
+ * Request:  RequestHeader, followed by pathLength bytes of the graph path
+ *           (DIMAC file, interpreted by the server, no terminating 0)
+ * Reply:    ReplyHeader, followed by numNodes uint32_t mates if
+ *           status == STATUS_OK. Unmatched nodes have mate UNMATCHED.
+ **/
+namespace protocol
+{
+	static const uint32_t MAGIC = 0x4d435444; // "DTCM"
+
+	static const uint32_t REQUEST_SOLVE = 1;
+
+	static const uint32_t STATUS_OK = 0;
+	static const uint32_t STATUS_LOAD_ERROR = 1;  //!< graph could not be loaded
+	static const uint32_t STATUS_BAD_REQUEST = 2; //!< malformed request
+	static const uint32_t STATUS_TOO_LARGE = 3;   //!< node IDs do not fit into uint32_t
+	static const uint32_t STATUS_SERVER_ERROR = 4; //!< e.g. out of memory
+
+	//! Mate of unmatched nodes. Graphs with UNMATCHED or more nodes are
+	//! rejected with STATUS_TOO_LARGE.
+	static const uint32_t UNMATCHED = 0xffffffff;
+
+	//! Upper limit on the path length, protects against garbage requests
+	static const uint32_t MAX_PATH_LENGTH = 4096;
+
+	struct RequestHeader
+	{
+		uint32_t magic;
+		uint32_t type;
+		uint32_t pathLength;
+	};
+
+	struct ReplyHeader
+	{
+		uint32_t magic;
+		uint32_t status;
+		uint64_t numNodes;
+		uint64_t matchingSize;
+	};
+
+	//! Read exactly @a size bytes from @a fd. Returns false on EOF/error.
+	bool readFull(int fd, void* data, std::size_t size);
+
+	//! Write exactly @a size bytes to @a fd. Returns false on error.
+	bool writeFull(int fd, const void* data, std::size_t size);
+
+	//! Connect to the server at @a path. Returns the socket or -1 on error.
+	int connect(const std::string& path);
+}
+
+#endif
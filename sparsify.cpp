@@ -0,0 +1,188 @@
+// Maximum matching on a sparsified graph with certification on the full graph
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "sparsify.h"
+#include "dense_graph.h"
+
+#include <algorithm>
+#include <random>
+
+// Add up to k random edges of v to @a edges, return the number of
+// adjacency entries examined.
+static std::size_t sampleEdges(const Graph& graph, NodeID v, unsigned int k,
+	std::mt19937_64& rng, std::vector<Graph::Edge>* edges)
+{
+	const std::vector<NodeID>& adjacent = graph.neighbors(v);
+
+	if(adjacent.size() <= k)
+	{
+		for(NodeID w : adjacent)
+		{
+			if(w != v)
+				edges->push_back(std::minmax(v, w));
+		}
+		return adjacent.size();
+	}
+
+	for(unsigned int i = 0; i < k; ++i)
+	{
+		NodeID w = adjacent[rng() % adjacent.size()];
+		if(w != v)
+			edges->push_back(std::minmax(v, w));
+	}
+	return k;
+}
+
+static std::size_t sampleEdges(const DenseGraph& graph, NodeID v, unsigned int k,
+	std::mt19937_64& rng, std::vector<Graph::Edge>* edges)
+{
+	std::size_t degree = graph.degree(v);
+
+	if(degree <= k)
+	{
+		for(NodeID w : graph.neighbors(v))
+		{
+			if(w != v)
+				edges->push_back(std::minmax(v, w));
+		}
+		return degree;
+	}
+
+	// Rejection sampling: test random matrix entries. We expect n/degree
+	// tests per edge, which is small for dense graphs. Give up after a
+	// fixed number of tests, H does not need to be complete.
+	std::size_t tests = 0;
+	std::size_t maxTests = 4 * k * (graph.numNodes() / degree + 1);
+	for(unsigned int found = 0; found < k && tests < maxTests; ++tests)
+	{
+		NodeID w = rng() % graph.numNodes();
+		if(w != v && graph.adjacent(v, w))
+		{
+			edges->push_back(std::minmax(v, w));
+			found++;
+		}
+	}
+	return tests;
+}
+
+SparsifiedMatching::SparsifiedMatching()
+ : m_edgesPerVertex(8)
+ , m_seed(std::random_device()())
+ , m_edgesTouched(0)
+ , m_rounds(0)
+{
+}
+
+void SparsifiedMatching::setEdgesPerVertex(unsigned int k)
+{
+	m_edgesPerVertex = std::max(1u, k);
+}
+
+void SparsifiedMatching::setSeed(uint64_t seed)
+{
+	m_seed = seed;
+}
+
+void SparsifiedMatching::buildSubgraph(NodeID numNodes)
+{
+	std::sort(m_edges.begin(), m_edges.end());
+	m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+
+	m_offsets.assign(numNodes + 1, 0);
+	for(const Graph::Edge& e : m_edges)
+	{
+		m_offsets[e.first + 1]++;
+		m_offsets[e.second + 1]++;
+	}
+	for(NodeID v = 0; v < numNodes; ++v)
+		m_offsets[v + 1] += m_offsets[v];
+
+	m_neighbors.resize(2 * m_edges.size());
+	std::vector<uint64_t> pos(m_offsets.begin(), m_offsets.end() - 1);
+	for(const Graph::Edge& e : m_edges)
+	{
+		m_neighbors[pos[e.first]++] = e.second;
+		m_neighbors[pos[e.second]++] = e.first;
+	}
+}
+
+template<class GraphT>
+std::size_t SparsifiedMatching::calculateMatching(const GraphT& graph)
+{
+	NodeID numNodes = graph.numNodes();
+	std::mt19937_64 rng(m_seed);
+
+	m_edges.clear();
+	m_expanded.assign(numNodes, false);
+	m_edgesTouched = 0;
+	m_rounds = 0;
+
+	for(NodeID v = 0; v < numNodes; ++v)
+		m_edgesTouched += sampleEdges(graph, v, m_edgesPerVertex, rng, &m_edges);
+
+	LargeVector<NodeID> mates;
+	std::vector<NodeID> offending;
+	std::size_t size;
+
+	while(1)
+	{
+		buildSubgraph(numNodes);
+		CSRGraph<uint64_t> subgraph(numNodes, m_offsets.data(), m_neighbors.data());
+
+		if(m_rounds == 0)
+			size = m_edmonds.calculateMatching(subgraph);
+		else
+			size = m_edmonds.calculateMatching(subgraph, mates);
+		m_rounds++;
+
+		// A perfect (or near-perfect) matching is maximum anyway
+		if(size == numNodes / 2)
+			break;
+
+		// Check the final forest of H against the edges of G. Expanded
+		// vertices have all their edges in H already.
+		offending.clear();
+		for(NodeID x = 0; x < numNodes; ++x)
+		{
+			if(m_expanded[x] || !m_edmonds.isOuter(x))
+				continue;
+
+			NodeID base = m_edmonds.blossomBase(x);
+			for(NodeID w : graph.neighbors(x))
+			{
+				m_edgesTouched++;
+
+				if(m_edmonds.isInner(w))
+					continue;
+				if(m_edmonds.isOuter(w) && m_edmonds.blossomBase(w) == base)
+					continue;
+
+				// w is out-of-forest or in another blossom: x could grow,
+				// shrink or augment in G
+				offending.push_back(x);
+				break;
+			}
+		}
+
+		if(offending.empty())
+			break;
+
+		for(NodeID x : offending)
+		{
+			m_expanded[x] = true;
+			for(NodeID w : graph.neighbors(x))
+			{
+				m_edgesTouched++;
+				if(w != x)
+					m_edges.push_back(std::minmax(x, w));
+			}
+		}
+
+		mates = m_edmonds.mates();
+	}
+
+	return size;
+}
+
+template std::size_t SparsifiedMatching::calculateMatching(const Graph& graph);
+template std::size_t SparsifiedMatching::calculateMatching(const DenseGraph& graph);
@@ -0,0 +1,91 @@
+// Maximum matching on a sparsified graph with certification on the full graph
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef SPARSIFY_H
+#define SPARSIFY_H
+
+#include "graph.h"
+#include "edmonds.h"
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Calculates a maximum matching of a dense graph G while examining only a
+ * fraction of its edges.
+ *
+ * The matching is first computed on a sparse subgraph H, which contains k
+ * random edges of each vertex. Random graphs with only a few edges per
+ * vertex have a (near-)perfect matching with high probability, so this
+ * matching is usually maximum in G as well. This is certified using the
+ * final forest of Edmonds' algorithm on H: if each outer vertex is only
+ * adjacent (in G) to inner vertices and outer vertices of its own blossom,
+ * no augmenting path exists in G. Otherwise, all edges of the offending
+ * outer vertices are added to H and the search continues from the current
+ * matching. A perfect matching needs no certificate at all.
+ *
+ * Only the edges around the outer vertices of the final forest are
+ * examined, which are few if the matching is (near-)perfect.
+ **/
+class SparsifiedMatching
+{
+public:
+	SparsifiedMatching();
+
+	//! Number of random edges per vertex in the initial subgraph (default: 8)
+	void setEdgesPerVertex(unsigned int k);
+
+	//! Seed for the random number generator (default: random)
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Calculate a maximum matching in @a graph. GraphT can be Graph or
+	 * DenseGraph.
+	 *
+	 * @return Size of the matching
+	 **/
+	template<class GraphT>
+	std::size_t calculateMatching(const GraphT& graph);
+
+	//! Result of the last calculateMatching() call (see BasicEdmondsMatching::mates())
+	const LargeVector<NodeID>& mates() const
+	{ return m_edmonds.mates(); }
+
+	/**
+	 * Number of adjacency entries (or adjacency tests) of the input graph
+	 * examined in the last calculateMatching() call.
+	 **/
+	std::size_t edgesTouched() const
+	{ return m_edgesTouched; }
+
+	//! Number of edges of the final subgraph H
+	std::size_t subgraphEdges() const
+	{ return m_edges.size(); }
+
+	//! Number of times the matching was calculated on the subgraph
+	unsigned int rounds() const
+	{ return m_rounds; }
+private:
+	//! Build the CSR arrays of H from m_edges
+	void buildSubgraph(NodeID numNodes);
+
+	unsigned int m_edgesPerVertex;
+	uint64_t m_seed;
+
+	//! Edges (v,w) of H with v < w
+	std::vector<Graph::Edge> m_edges;
+
+	//! Has the full adjacency of v been added to H?
+	std::vector<bool> m_expanded;
+
+	std::vector<uint64_t> m_offsets;
+	std::vector<uint64_t> m_neighbors;
+
+	BasicEdmondsMatching<CSRGraph<uint64_t>> m_edmonds;
+
+	std::size_t m_edgesTouched;
+	unsigned int m_rounds;
+};
+
+#endif
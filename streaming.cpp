@@ -0,0 +1,141 @@
+// Semi-streaming matching on DIMAC edge streams
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "streaming.h"
+#include "dimac.h"
+
+StreamingMatching::StreamingMatching()
+ : m_size(0)
+ , m_passes(0)
+{
+}
+
+void StreamingMatching::header(NodeID numNodes, std::size_t)
+{
+	if(m_passes == 0)
+	{
+		m_mu.resize(numNodes);
+		for(NodeID v = 0; v < numNodes; ++v)
+			m_mu[v] = v;
+	}
+	else
+	{
+		if(numNodes != m_mu.size())
+			throw Graph::LoadError("DIMAC header changed between passes");
+
+		m_candidates.resize(2*numNodes);
+		for(NodeID v = 0; v < numNodes; ++v)
+		{
+			m_candidates[2*v] = v;
+			m_candidates[2*v+1] = v;
+		}
+	}
+}
+
+void StreamingMatching::addCandidate(NodeID v, NodeID x)
+{
+	NodeID* c = &m_candidates[2*v];
+	if(c[0] == v)
+		c[0] = x;
+	else if(c[1] == v && c[0] != x)
+		c[1] = x;
+}
+
+void StreamingMatching::edge(NodeID v, NodeID w)
+{
+	bool vExposed = (m_mu[v] == v);
+	bool wExposed = (m_mu[w] == w);
+
+	if(vExposed && wExposed)
+	{
+		// Greedy step (only happens in the first pass, since the matching
+		// is maximal afterwards)
+		if(v == w)
+			return;
+
+		m_mu[v] = w;
+		m_mu[w] = v;
+		m_size++;
+	}
+	else if(m_passes != 0)
+	{
+		if(vExposed)
+			addCandidate(w, v);
+		else if(wExposed)
+			addCandidate(v, w);
+	}
+}
+
+std::size_t StreamingMatching::augment()
+{
+	std::size_t augmented = 0;
+
+	for(NodeID u = 0; u < m_mu.size(); ++u)
+	{
+		NodeID v = m_mu[u];
+
+		// Consider each matching edge {u,v} once
+		if(v <= u)
+			continue;
+
+		// Find distinct exposed ends x (adjacent to u) and y (adjacent to v).
+		// Candidates may have been matched by earlier augmentations.
+		for(int i = 0; i < 2; ++i)
+		{
+			NodeID x = m_candidates[2*u+i];
+			if(x == u || m_mu[x] != x)
+				continue;
+
+			NodeID y = v;
+			for(int j = 0; j < 2; ++j)
+			{
+				NodeID c = m_candidates[2*v+j];
+				if(c != v && c != x && m_mu[c] == c)
+				{
+					y = c;
+					break;
+				}
+			}
+
+			if(y == v)
+				continue;
+
+			// Augment along x - u = v - y
+			m_mu[x] = u;
+			m_mu[u] = x;
+			m_mu[v] = y;
+			m_mu[y] = v;
+			augmented++;
+			break;
+		}
+	}
+
+	m_size += augmented;
+	return augmented;
+}
+
+std::size_t StreamingMatching::pass(std::istream& stream)
+{
+	std::size_t oldSize = m_size;
+
+	parseDIMAC(stream, *this);
+
+	if(m_passes != 0)
+		augment();
+
+	m_passes++;
+
+	return m_size - oldSize;
+}
+
+void StreamingMatching::toDIMAC(std::ostream& stream) const
+{
+	stream << "p edge " << m_mu.size() << " " << m_size << "\n";
+
+	for(NodeID v = 0; v < m_mu.size(); ++v)
+	{
+		// DIMAC is 1-based, we are 0-based
+		if(m_mu[v] > v)
+			stream << "e " << (v+1) << " " << (m_mu[v]+1) << "\n";
+	}
+}
@@ -0,0 +1,78 @@
+// Semi-streaming matching on DIMAC edge streams
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include "graph.h"
+
+#include <vector>
+#include <iostream>
+
+/**
+ * Calculates a large matching of a graph which is only available as a
+ * stream of edges, using O(n) memory.
+ *
+ * The first pass builds a maximal matching greedily. Each further pass
+ * searches for vertex-disjoint augmenting paths of length three
+ * (x - u = v - y with x,y exposed) and augments along them. Since the
+ * matching stays maximal, the first pass guarantees a 1/2-approximation.
+ **/
+class StreamingMatching
+{
+public:
+	StreamingMatching();
+
+	/**
+	 * Run one pass over the edge stream @a stream. The first call builds
+	 * the greedy matching, subsequent calls improve it.
+	 *
+	 * @return Number of edges added to the matching in this pass
+	 * @throw Graph::LoadError on malformed input
+	 **/
+	std::size_t pass(std::istream& stream);
+
+	//! Number of completed passes
+	unsigned int numPasses() const
+	{ return m_passes; }
+
+	//! Number of nodes as specified in the DIMAC header
+	NodeID numNodes() const
+	{ return m_mu.size(); }
+
+	//! Size of the current matching
+	std::size_t size() const
+	{ return m_size; }
+
+	//! Current matching: v is matched to mates()[v], unmatched if mates()[v] == v
+	const std::vector<NodeID>& mates() const
+	{ return m_mu; }
+
+	//! Write the current matching as DIMAC graph into stream @a stream
+	void toDIMAC(std::ostream& stream) const;
+
+	// parseDIMAC() handler interface
+	void header(NodeID numNodes, std::size_t numEdges);
+	void edge(NodeID v, NodeID w);
+private:
+	//! Record exposed vertex @a x as augmentation candidate for matched @a v
+	void addCandidate(NodeID v, NodeID x);
+
+	//! Augment along the collected paths of length three
+	std::size_t augment();
+
+	//! mu mapping: {v,w} in matching <=> m_mu[v] == w.
+	std::vector<NodeID> m_mu;
+
+	/**
+	 * Two exposed neighbors for each matched vertex v, stored at 2v and
+	 * 2v+1. Empty slots contain v itself. Two candidates per vertex
+	 * suffice to find distinct ends for each matching edge.
+	 **/
+	std::vector<NodeID> m_candidates;
+
+	std::size_t m_size;
+	unsigned int m_passes;
+};
+
+#endif
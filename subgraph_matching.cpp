@@ -0,0 +1,47 @@
+// Matching queries on subgraphs of a shared graph
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "subgraph_matching.h"
+
+SubgraphMatching::SubgraphMatching(const Graph& graph, const LargeVector<NodeID>* baseMates)
+ : m_graph(&graph)
+ , m_baseMates(baseMates)
+{
+}
+
+std::size_t SubgraphMatching::calculateMatching(const std::vector<bool>* removedNodes, const EdgeMask<Graph>* removedEdges)
+{
+	MaskedGraph<Graph> subgraph(*m_graph, removedNodes, removedEdges);
+
+	if(!m_baseMates)
+		return m_edmond.calculateMatching(subgraph);
+
+	// Restrict the base matching to the subgraph
+	m_initialMates = *m_baseMates;
+
+	if(removedNodes)
+	{
+		for(NodeID v = 0; v < m_graph->numNodes(); ++v)
+		{
+			if((*removedNodes)[v])
+			{
+				m_initialMates[m_initialMates[v]] = m_initialMates[v];
+				m_initialMates[v] = v;
+			}
+		}
+	}
+
+	if(removedEdges)
+	{
+		for(const Graph::Edge& e : removedEdges->edges())
+		{
+			if(m_initialMates[e.first] == e.second)
+			{
+				m_initialMates[e.first] = e.first;
+				m_initialMates[e.second] = e.second;
+			}
+		}
+	}
+
+	return m_edmond.calculateMatching(subgraph, m_initialMates);
+}
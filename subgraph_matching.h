@@ -0,0 +1,55 @@
+// Matching queries on subgraphs of a shared graph
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef SUBGRAPH_MATCHING_H
+#define SUBGRAPH_MATCHING_H
+
+#include "edmonds.h"
+#include "masked_graph.h"
+
+/**
+ * Calculates maximum matchings of subgraphs of a shared, read-only graph
+ * ("G without these nodes/edges") without copying the graph.
+ *
+ * If a matching of the full graph is given, each query starts from its
+ * restriction to the subgraph, which usually leaves only few augmentations
+ * to do.
+ *
+ * The graph and base matching are only read, so queries can run in
+ * parallel with one SubgraphMatching instance per thread.
+ **/
+class SubgraphMatching
+{
+public:
+	/**
+	 * @param graph The full graph
+	 * @param baseMates Optional matching of @a graph (see
+	 *   EdmondsCardinalityMatching::mates()) used to warm-start each query
+	 **/
+	explicit SubgraphMatching(const Graph& graph, const LargeVector<NodeID>* baseMates = 0);
+
+	/**
+	 * Calculate a maximum matching of the graph without the nodes marked
+	 * in @a removedNodes and the edges in @a removedEdges (both optional).
+	 *
+	 * @return Size of the matching
+	 **/
+	std::size_t calculateMatching(const std::vector<bool>* removedNodes, const EdgeMask<Graph>* removedEdges);
+
+	/**
+	 * Result of the last calculateMatching() call: v is matched to
+	 * mates()[v], or unmatched if mates()[v] == v.
+	 **/
+	const LargeVector<NodeID>& mates() const
+	{ return m_edmond.mates(); }
+private:
+	const Graph* m_graph;
+	const LargeVector<NodeID>* m_baseMates;
+
+	BasicEdmondsMatching<MaskedGraph<Graph>> m_edmond;
+
+	//! Restriction of the base matching to the current subgraph
+	LargeVector<NodeID> m_initialMates;
+};
+
+#endif
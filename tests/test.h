@@ -0,0 +1,50 @@
+// Minimal helpers for the unit tests (run with ctest)
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+namespace test
+{
+	//! Number of failed checks so far
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	//! Exit code for main()
+	inline int result()
+	{
+		if(failures() != 0)
+			fprintf(stderr, "%d check(s) failed\n", failures());
+		return failures() != 0 ? 1 : 0;
+	}
+}
+
+//! Record a failure if @a cond is false
+#define CHECK(cond) \
+	do { \
+		if(!(cond)) \
+		{ \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			test::failures()++; \
+		} \
+	} while(0)
+
+//! Record a failure unless @a expr throws an exception of type @a type
+#define CHECK_THROWS(expr, type) \
+	do { \
+		bool thrown = false; \
+		try { expr; } \
+		catch(type&) { thrown = true; } \
+		if(!thrown) \
+		{ \
+			fprintf(stderr, "%s:%d: %s did not throw %s\n", __FILE__, __LINE__, #expr, #type); \
+			test::failures()++; \
+		} \
+	} while(0)
+
+#endif
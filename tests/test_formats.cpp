@@ -0,0 +1,44 @@
+// Tests for the graph file parsers
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "test.h"
+
+#include "../graph.h"
+#include "../graph_formats.h"
+
+#include <sstream>
+#include <string>
+
+static void load(const std::string& contents, formats::Format format = formats::AUTO)
+{
+	std::istringstream stream(contents);
+	Graph graph;
+	graph.load(stream, format);
+}
+
+static void testValid()
+{
+	std::istringstream stream("p edge 3 2\ne 1 2\ne 2 3\n");
+	Graph graph;
+	graph.load(stream);
+	CHECK(graph.numNodes() == 3);
+	CHECK(graph.numEdges() == 2);
+}
+
+static void testOverflow()
+{
+	// 2^64 + 1 would wrap around to 1 without the overflow check
+	CHECK_THROWS(load("p edge 3 1\ne 18446744073709551617 2\n"), Graph::LoadError);
+	CHECK_THROWS(load("18446744073709551617 2\n", formats::SNAP), Graph::LoadError);
+	CHECK_THROWS(load("99999999999999999999 1\n1\n", formats::METIS), Graph::LoadError);
+
+	// The largest 64-bit value itself parses (and is then out of bounds)
+	CHECK_THROWS(load("p edge 3 1\ne 18446744073709551615 2\n"), Graph::LoadError);
+}
+
+int main()
+{
+	testValid();
+	testOverflow();
+	return test::result();
+}
@@ -0,0 +1,121 @@
+// Tests for the matching server (edmonds --server)
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "test.h"
+
+#include "../server.h"
+#include "../server_protocol.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Connect to the server at @a socket, waiting until it is listening
+static int connectToServer(const std::string& socket)
+{
+	for(int i = 0; i < 100; ++i)
+	{
+		int fd = protocol::connect(socket);
+		if(fd >= 0)
+		{
+			// Fail instead of hanging if the server does not answer
+			struct timeval timeout = {10, 0};
+			setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			return fd;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+
+	return -1;
+}
+
+//! Send a solve request for @a graph and return the reply status (or -1)
+static int solve(int fd, const std::string& graph, uint64_t* matchingSize)
+{
+	protocol::RequestHeader request;
+	request.magic = protocol::MAGIC;
+	request.type = protocol::REQUEST_SOLVE;
+	request.pathLength = graph.size();
+
+	protocol::ReplyHeader reply;
+	if(!protocol::writeFull(fd, &request, sizeof(request))
+		|| !protocol::writeFull(fd, graph.data(), graph.size())
+		|| !protocol::readFull(fd, &reply, sizeof(reply)))
+		return -1;
+
+	if(reply.status == protocol::STATUS_OK)
+	{
+		std::vector<uint32_t> mates(reply.numNodes);
+		if(!protocol::readFull(fd, mates.data(), mates.size() * sizeof(uint32_t)))
+			return -1;
+	}
+
+	*matchingSize = reply.matchingSize;
+	return reply.status;
+}
+
+int main()
+{
+	char dir[] = "/tmp/edmonds-test-XXXXXX";
+	if(!mkdtemp(dir))
+	{
+		perror("Could not create temporary directory");
+		return 1;
+	}
+
+	std::string socket = std::string(dir) + "/server.sock";
+	std::string graph = std::string(dir) + "/path.dmx";
+	{
+		std::ofstream out(graph);
+		out << "p edge 4 3\ne 1 2\ne 2 3\ne 3 4\n";
+	}
+
+	// A single worker, so that one stalled client would block everything.
+	// run() does not return, the thread ends with the process.
+	std::thread serverThread([&]() {
+		MatchingServer server(1, 4);
+		server.run(socket);
+	});
+	serverThread.detach();
+
+	// Client which sends only part of a request header ...
+	int halfOpen = connectToServer(socket);
+	CHECK(halfOpen >= 0);
+	uint32_t magic = protocol::MAGIC;
+	CHECK(protocol::writeFull(halfOpen, &magic, sizeof(magic)));
+
+	// ... and one which sends nothing at all
+	int silent = connectToServer(socket);
+	CHECK(silent >= 0);
+
+	// must not keep the worker from serving other clients
+	int client = connectToServer(socket);
+	CHECK(client >= 0);
+
+	uint64_t size = 0;
+	CHECK(solve(client, graph, &size) == int(protocol::STATUS_OK));
+	CHECK(size == 2);
+
+	// The connection is reusable
+	CHECK(solve(client, graph, &size) == int(protocol::STATUS_OK));
+	CHECK(solve(client, std::string(dir) + "/missing.dmx", &size) == int(protocol::STATUS_LOAD_ERROR));
+
+	close(client);
+	close(silent);
+	close(halfOpen);
+
+	unlink(socket.c_str());
+	unlink(graph.c_str());
+	rmdir(dir);
+
+	return test::result();
+}
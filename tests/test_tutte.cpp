@@ -0,0 +1,72 @@
+// Randomized cross-check of the Tutte matrix rank against Edmonds
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "test.h"
+
+#include "../graph.h"
+#include "../dense_graph.h"
+#include "../edmonds.h"
+#include "../tutte.h"
+
+#include <random>
+
+int main()
+{
+	std::mt19937_64 rng(42);
+
+	// Sizes below and above the panel width (64) of the elimination
+	const unsigned int sizes[] = {1, 2, 7, 31, 64, 65, 100, 150};
+	const double densities[] = {0.01, 0.05, 0.2, 0.6};
+
+	EdmondsCardinalityMatching edmond;
+
+	for(unsigned int n : sizes)
+	{
+		for(double density : densities)
+		{
+			std::bernoulli_distribution edge(density);
+
+			Graph graph;
+			graph.reset(n);
+			DenseGraph dense;
+			dense.reset(n);
+
+			for(NodeID v = 0; v < n; ++v)
+			{
+				for(NodeID w = v+1; w < n; ++w)
+				{
+					if(edge(rng))
+					{
+						graph.addEdge(v, w);
+						dense.addEdge(v, w);
+					}
+				}
+			}
+
+			std::size_t expected = edmond.calculateMatching(graph);
+
+			// Several threads, so that the trailing updates use the pool
+			TutteMatchingNumber tutte;
+			tutte.setSeed(rng());
+			tutte.setThreads(3);
+
+			std::size_t size = tutte.calculate(graph);
+			CHECK(size == expected);
+			if(size != expected)
+				fprintf(stderr, "n = %u, density %.2f: Tutte %lu, Edmonds %lu\n", n, density, size, expected);
+
+			CHECK(tutte.calculate(dense) == expected);
+		}
+	}
+
+	// Memory estimate of the n x n matrix saturates instead of overflowing
+	MemoryUsage usage;
+	TutteMatchingNumber::estimateMemory(1000, &usage);
+	CHECK(usage.total() == 4000000);
+
+	MemoryUsage huge;
+	TutteMatchingNumber::estimateMemory(NodeID(1) << 40, &huge);
+	CHECK(huge.total() == SIZE_MAX);
+
+	return test::result();
+}
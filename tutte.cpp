@@ -0,0 +1,378 @@
+// Matching number via the rank of the Tutte matrix
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "tutte.h"
+#include "dense_graph.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+// Number of columns eliminated together (panel width). The multipliers of
+// a panel are applied to the trailing matrix in one pass.
+static const std::size_t PanelWidth = 64;
+
+// Number of trailing columns updated together. The corresponding part of
+// the pivot rows (PanelWidth x TileWidth) should fit into the L2 cache.
+static const std::size_t TileWidth = 1024;
+
+const uint32_t TutteMatchingNumber::Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// ARITHMETIC MODULO 2^31-1
+
+// Partial reduction: For x < 2^64, the result is congruent to x and
+// smaller than 2^33 + 2^31. This is cheap and vectorizes well.
+static inline uint64_t fold(uint64_t x)
+{
+	return (x & TutteMatchingNumber::Prime) + (x >> 31);
+}
+
+static inline uint32_t reduce(uint64_t x)
+{
+	x = fold(fold(x));
+	if(x >= TutteMatchingNumber::Prime)
+		x -= TutteMatchingNumber::Prime;
+	return x;
+}
+
+static inline uint32_t mulMod(uint32_t a, uint32_t b)
+{
+	return reduce(uint64_t(a) * b);
+}
+
+static inline uint32_t negMod(uint32_t a)
+{
+	return a ? TutteMatchingNumber::Prime - a : 0;
+}
+
+static uint32_t invMod(uint32_t a)
+{
+	// Fermat: a^(p-2) = a^-1 mod p
+	uint32_t result = 1;
+	uint32_t exp = TutteMatchingNumber::Prime - 2;
+	while(exp)
+	{
+		if(exp & 1)
+			result = mulMod(result, a);
+		a = mulMod(a, a);
+		exp >>= 1;
+	}
+	return result;
+}
+
+// dest[i] = dest[i] + factor * src[i] (mod p) for i in [0,count)
+static inline void addMultiple(uint32_t* dest, const uint32_t* src, uint32_t factor, std::size_t count)
+{
+	for(std::size_t i = 0; i < count; ++i)
+		dest[i] = reduce(dest[i] + uint64_t(factor) * src[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TutteMatchingNumber::TutteMatchingNumber()
+ : m_repetitions(2)
+ , m_threads(std::max(1u, std::thread::hardware_concurrency()))
+ , m_seed(std::random_device()())
+{
+}
+
+void TutteMatchingNumber::setRepetitions(unsigned int repetitions)
+{
+	m_repetitions = std::max(1u, repetitions);
+}
+
+void TutteMatchingNumber::setThreads(unsigned int threads)
+{
+	m_threads = std::max(1u, threads);
+}
+
+void TutteMatchingNumber::setSeed(uint64_t seed)
+{
+	m_seed = seed;
+}
+
+namespace
+{
+	/**
+	 * Threads for the trailing updates of one factorization. They are
+	 * started once and then run one job per panel, instead of creating
+	 * new threads for each of the n/PanelWidth panels.
+	 **/
+	class UpdatePool
+	{
+	public:
+		explicit UpdatePool(std::size_t numThreads)
+		 : m_func(0)
+		 , m_numJobs(0)
+		 , m_generation(0)
+		 , m_pending(0)
+		 , m_stop(false)
+		{
+			for(std::size_t t = 1; t < numThreads; ++t)
+				m_threads.emplace_back(&UpdatePool::worker, this, t);
+		}
+
+		~UpdatePool()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_stop = true;
+				m_start.notify_all();
+			}
+
+			for(std::thread& thread : m_threads)
+				thread.join();
+		}
+
+		//! Number of threads including the calling one
+		std::size_t size() const
+		{ return m_threads.size() + 1; }
+
+		/**
+		 * Run func(i) for i in [0,numJobs) with numJobs <= size() and
+		 * wait for completion. Job 0 runs in the calling thread.
+		 **/
+		void run(std::size_t numJobs, const std::function<void(std::size_t)>& func)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_func = &func;
+				m_numJobs = numJobs;
+				m_pending = m_threads.size();
+				m_generation++;
+				m_start.notify_all();
+			}
+
+			if(numJobs != 0)
+				func(0);
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while(m_pending != 0)
+				m_done.wait(lock);
+		}
+	private:
+		void worker(std::size_t index)
+		{
+			uint64_t generation = 0;
+			while(1)
+			{
+				const std::function<void(std::size_t)>* func;
+				std::size_t numJobs;
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					while(!m_stop && m_generation == generation)
+						m_start.wait(lock);
+					if(m_stop)
+						return;
+
+					generation = m_generation;
+					func = m_func;
+					numJobs = m_numJobs;
+				}
+
+				if(index < numJobs)
+					(*func)(index);
+
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if(--m_pending == 0)
+					m_done.notify_one();
+			}
+		}
+
+		std::vector<std::thread> m_threads;
+		std::mutex m_mutex;
+		std::condition_variable m_start;
+		std::condition_variable m_done;
+
+		const std::function<void(std::size_t)>* m_func;
+		std::size_t m_numJobs;
+		uint64_t m_generation;
+		std::size_t m_pending;
+		bool m_stop;
+	};
+
+	/**
+	 * Trailing update A22 -= L21 * U12 for the rows [begin,end) of the
+	 * matrix. The multipliers of row j are stored in the pivot columns
+	 * of row j, the pivot rows start at row @a pivotRow.
+	 **/
+	void updateRows(uint32_t* A, std::size_t n,
+		std::size_t begin, std::size_t end,
+		const std::vector<std::size_t>& pivotColumns, std::size_t pivotRow,
+		std::size_t firstColumn)
+	{
+		uint64_t acc[TileWidth];
+		std::vector<uint32_t> factors(pivotColumns.size());
+
+		for(std::size_t t0 = firstColumn; t0 < n; t0 += TileWidth)
+		{
+			std::size_t width = std::min(TileWidth, n - t0);
+
+			for(std::size_t j = begin; j < end; ++j)
+			{
+				uint32_t* row = A + j*n;
+
+				for(std::size_t k = 0; k < pivotColumns.size(); ++k)
+					factors[k] = negMod(row[pivotColumns[k]]);
+
+				for(std::size_t c = 0; c < width; ++c)
+					acc[c] = row[t0 + c];
+
+				// Delayed reduction: acc stays below 2^34 after fold(), so
+				// we can add one product < 2^62 without overflow.
+				for(std::size_t k = 0; k < pivotColumns.size(); ++k)
+				{
+					uint64_t f = factors[k];
+					if(!f)
+						continue;
+
+					const uint32_t* u = A + (pivotRow + k)*n + t0;
+					for(std::size_t c = 0; c < width; ++c)
+						acc[c] = fold(acc[c] + f * u[c]);
+				}
+
+				for(std::size_t c = 0; c < width; ++c)
+					row[t0 + c] = reduce(acc[c]);
+			}
+		}
+	}
+}
+
+std::size_t TutteMatchingNumber::rank(uint32_t* A, std::size_t n)
+{
+	std::size_t rank = 0;
+	std::vector<std::size_t> pivotColumns;
+	pivotColumns.reserve(PanelWidth);
+
+	// No thread needs more than 64 rows
+	UpdatePool pool(std::min<std::size_t>(m_threads, (n + 63) / 64));
+
+	for(std::size_t c0 = 0; c0 < n && rank < n; c0 += PanelWidth)
+	{
+		std::size_t c1 = std::min(c0 + PanelWidth, n);
+		std::size_t pivotRow = rank;
+		pivotColumns.clear();
+
+		// Eliminate inside the panel columns [c0,c1) only. The multipliers
+		// are stored in place of the eliminated entries.
+		for(std::size_t c = c0; c < c1 && rank < n; ++c)
+		{
+			std::size_t p = rank;
+			while(p < n && A[p*n + c] == 0)
+				p++;
+
+			if(p == n)
+				continue; // no pivot in this column
+
+			if(p != rank)
+				std::swap_ranges(A + p*n, A + (p+1)*n, A + rank*n);
+
+			const uint32_t* pivot = A + rank*n;
+			uint32_t inv = invMod(pivot[c]);
+
+			for(std::size_t j = rank+1; j < n; ++j)
+			{
+				uint32_t* row = A + j*n;
+				if(row[c] == 0)
+					continue;
+
+				row[c] = mulMod(row[c], inv);
+				addMultiple(row + c + 1, pivot + c + 1, negMod(row[c]), c1 - c - 1);
+			}
+
+			pivotColumns.push_back(c);
+			rank++;
+		}
+
+		if(pivotColumns.empty() || c1 == n)
+			continue;
+
+		// Apply the panel to the trailing columns of the pivot rows
+		// (triangular solve U12 = L11^-1 A12).
+		for(std::size_t k = 0; k < pivotColumns.size(); ++k)
+		{
+			const uint32_t* src = A + (pivotRow + k)*n + c1;
+			for(std::size_t k2 = k+1; k2 < pivotColumns.size(); ++k2)
+			{
+				uint32_t* dest = A + (pivotRow + k2)*n;
+				addMultiple(dest + c1, src, negMod(dest[pivotColumns[k]]), n - c1);
+			}
+		}
+
+		// Trailing update of the remaining rows, distributed over threads
+		std::size_t numRows = n - rank;
+		if(numRows == 0)
+			continue;
+
+		std::size_t numJobs = std::min<std::size_t>(pool.size(), (numRows + 63) / 64);
+		pool.run(numJobs, [&](std::size_t t) {
+			updateRows(A, n,
+				rank + numRows * t / numJobs, rank + numRows * (t+1) / numJobs,
+				pivotColumns, pivotRow, c1
+			);
+		});
+	}
+
+	return rank;
+}
+
+template<class GraphT>
+std::size_t TutteMatchingNumber::calculate(const GraphT& graph)
+{
+	std::size_t n = graph.numNodes();
+	if(n != 0 && n > SIZE_MAX / sizeof(uint32_t) / n)
+		throw std::length_error("Tutte matrix is too large");
+
+	std::vector<uint32_t> matrix(n*n);
+
+	std::mt19937_64 rng(m_seed);
+	std::uniform_int_distribution<uint32_t> dist(1, Prime - 1);
+
+	std::size_t best = 0;
+	for(unsigned int i = 0; i < m_repetitions; ++i)
+	{
+		std::fill(matrix.begin(), matrix.end(), 0);
+
+		// Skew-symmetric Tutte matrix with random values x_vw
+		for(NodeID v = 0; v < n; ++v)
+		{
+			for(NodeID w : graph.neighbors(v))
+			{
+				if(w <= v)
+					continue;
+
+				uint32_t x = dist(rng);
+				matrix[v*n + w] = x;
+				matrix[w*n + v] = Prime - x;
+			}
+		}
+
+		best = std::max(best, rank(matrix.data(), n));
+
+		// The rank cannot get any better than this
+		if(best >= n - (n % 2))
+			break;
+	}
+
+	return best / 2;
+}
+
+void TutteMatchingNumber::estimateMemory(NodeID numNodes, MemoryUsage* usage)
+{
+	// Saturate instead of overflowing for absurd node counts
+	std::size_t bytes = SIZE_MAX;
+	if(numNodes == 0 || numNodes <= SIZE_MAX / sizeof(uint32_t) / numNodes)
+		bytes = numNodes * numNodes * sizeof(uint32_t);
+
+	usage->add("Tutte matrix", bytes);
+}
+
+template std::size_t TutteMatchingNumber::calculate(const Graph& graph);
+template std::size_t TutteMatchingNumber::calculate(const DenseGraph& graph);
@@ -0,0 +1,66 @@
+// Matching number via the rank of the Tutte matrix
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef TUTTE_H
+#define TUTTE_H
+
+#include "graph.h"
+#include "memory_usage.h"
+
+#include <stdint.h>
+
+/**
+ * Calculates the size of a maximum matching (but not the matching itself)
+ * using Lovász' randomized algorithm: The rank of the Tutte matrix of G,
+ * instantiated with random values over the prime field Z_p, is twice the
+ * matching number with probability at least 1 - n/p.
+ *
+ * The rank never exceeds twice the matching number, so we take the
+ * maximum over several repetitions to decrease the error probability.
+ *
+ * Runtime: O(n^3) per repetition, using a cache-blocked and multi-threaded
+ * Gaussian elimination. Memory: the dense n x n matrix, 4n^2 bytes (see
+ * estimateMemory()).
+ **/
+class TutteMatchingNumber
+{
+public:
+	//! We work modulo the Mersenne prime 2^31-1, which allows fast reduction
+	static const uint32_t Prime = 2147483647u;
+
+	TutteMatchingNumber();
+
+	//! Number of independent random instantiations (default: 2)
+	void setRepetitions(unsigned int repetitions);
+
+	//! Number of worker threads (default: hardware concurrency)
+	void setThreads(unsigned int threads);
+
+	//! Seed for the random number generator (default: random)
+	void setSeed(uint64_t seed);
+
+	/**
+	 * Calculate the matching number of @a graph. GraphT can be Graph or
+	 * DenseGraph.
+	 *
+	 * @throw std::length_error if the matrix size overflows
+	 * @throw std::bad_alloc if the matrix does not fit into memory
+	 **/
+	template<class GraphT>
+	std::size_t calculate(const GraphT& graph);
+
+	//! Add the memory needed for a graph with @a numNodes nodes to @a usage
+	static void estimateMemory(NodeID numNodes, MemoryUsage* usage);
+
+	/**
+	 * Calculate the rank of the n x n matrix @a matrix (row-major) over
+	 * Z_p. All entries need to be < Prime. The matrix is destroyed.
+	 **/
+	std::size_t rank(uint32_t* matrix, std::size_t n);
+private:
+	unsigned int m_repetitions;
+	unsigned int m_threads;
+	uint64_t m_seed;
+};
+
+#endif
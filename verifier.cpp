@@ -21,7 +21,7 @@ int main(int argc, char** argv)
 
 	Graph graph;
 	std::ifstream stream(argv[1]);
-	graph.loadDIMAC(stream);
+	graph.load(stream);
 
 	printf("Loaded graph with %u nodes and %u edges\n", graph.numNodes(), graph.numEdges());
 
@@ -0,0 +1,74 @@
+// Undirected graph with edge weights
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "weighted_graph.h"
+#include "graph_formats.h"
+
+WeightedGraph::WeightedGraph()
+ : m_nodeCount(0)
+ , m_offsets(1, 0)
+{
+}
+
+void WeightedGraph::header(NodeID numNodes, std::size_t numEdges)
+{
+	m_nodeCount = numNodes;
+	m_edges.clear();
+	m_edges.reserve(numEdges);
+}
+
+void WeightedGraph::edge(NodeID v, NodeID w)
+{
+	edge(v, w, 1.0);
+}
+
+void WeightedGraph::edge(NodeID v, NodeID w, Weight weight)
+{
+	if(v == w)
+		return;
+
+	WeightedEdge e;
+	e.v = v;
+	e.w = w;
+	e.weight = weight;
+	m_edges.push_back(e);
+}
+
+void WeightedGraph::load(std::istream& stream)
+{
+	load(stream, formats::AUTO);
+}
+
+void WeightedGraph::load(std::istream& stream, formats::Format format)
+{
+	parseGraph(stream, *this, 0, format);
+	build();
+}
+
+void WeightedGraph::build()
+{
+	// Counting sort of the adjacency entries by source node
+	m_offsets.assign(m_nodeCount + 1, 0);
+	for(const WeightedEdge& e : m_edges)
+	{
+		m_offsets[e.v + 1]++;
+		m_offsets[e.w + 1]++;
+	}
+
+	for(NodeID v = 0; v < m_nodeCount; ++v)
+		m_offsets[v+1] += m_offsets[v];
+
+	m_neighbors.resize(m_offsets[m_nodeCount]);
+	m_weights.resize(m_offsets[m_nodeCount]);
+
+	LargeVector<uint64_t> pos(m_offsets.begin(), m_offsets.end() - 1);
+	for(const WeightedEdge& e : m_edges)
+	{
+		m_neighbors[pos[e.v]] = e.w;
+		m_weights[pos[e.v]++] = e.weight;
+		m_neighbors[pos[e.w]] = e.v;
+		m_weights[pos[e.w]++] = e.weight;
+	}
+
+	LargeVector<WeightedEdge>().swap(m_edges);
+}
@@ -0,0 +1,88 @@
+// Undirected graph with edge weights
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef WEIGHTED_GRAPH_H
+#define WEIGHTED_GRAPH_H
+
+#include "graph.h"
+#include "csr_graph.h"
+
+#include <stdint.h>
+
+#include <istream>
+
+/**
+ * Undirected graph with edge weights in CSR format.
+ *
+ * Weights are read from DIMAC edge lines "e v w weight". Edges without
+ * weight (and edges from the other input formats) get weight 1. The
+ * weights of the neighbors of v are stored in the same order as
+ * neighbors(v).
+ **/
+class WeightedGraph
+{
+public:
+	typedef double Weight;
+
+	WeightedGraph();
+
+	/**
+	 * Load a graph in any supported format (see parseGraph()).
+	 *
+	 * @throw Graph::LoadError on malformed input
+	 **/
+	void load(std::istream& stream);
+
+	//! Load a graph in format @a format (see parseGraph())
+	void load(std::istream& stream, formats::Format format);
+
+	//! Return number of nodes in the graph
+	NodeID numNodes() const
+	{ return m_nodeCount; }
+
+	//! Return number of edges in the graph (without self loops)
+	std::size_t numEdges() const
+	{ return m_neighbors.size() / 2; }
+
+	//! Return the adjacent nodes of @a v
+	CSRGraph<uint64_t>::NeighborRange neighbors(NodeID v) const
+	{ return CSRGraph<uint64_t>::NeighborRange(m_neighbors.data() + m_offsets[v], m_neighbors.data() + m_offsets[v+1]); }
+
+	//! Return the weights of the edges to neighbors(v)
+	const Weight* weights(NodeID v) const
+	{ return m_weights.data() + m_offsets[v]; }
+
+	//! Return the number of adjacent nodes of @a v
+	std::size_t degree(NodeID v) const
+	{ return m_offsets[v+1] - m_offsets[v]; }
+
+	//! Unweighted CSR view, e.g. for the cardinality matching
+	CSRGraph<uint64_t> view() const
+	{ return CSRGraph<uint64_t>(m_nodeCount, m_offsets.data(), m_neighbors.data()); }
+
+	// parseGraph() handler interface
+	void header(NodeID numNodes, std::size_t numEdges);
+	void edge(NodeID v, NodeID w);
+	void edge(NodeID v, NodeID w, Weight weight);
+private:
+	struct WeightedEdge
+	{
+		NodeID v;
+		NodeID w;
+		Weight weight;
+	};
+
+	//! Build the CSR arrays from m_edges
+	void build();
+
+	NodeID m_nodeCount;
+
+	//! Edge list, only used while loading
+	LargeVector<WeightedEdge> m_edges;
+
+	LargeVector<uint64_t> m_offsets;
+	LargeVector<uint64_t> m_neighbors;
+	LargeVector<Weight> m_weights;
+};
+
+#endif
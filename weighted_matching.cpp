@@ -0,0 +1,264 @@
+// Approximate maximum weight matching
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#include "weighted_matching.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+WeightedMatching::WeightedMatching()
+ : m_graph(0)
+ , m_threads(std::max(1u, std::thread::hardware_concurrency()))
+ , m_rounds(0)
+ , m_weight(0.0)
+{
+}
+
+void WeightedMatching::setThreads(unsigned int threads)
+{
+	m_threads = std::max(1u, threads);
+}
+
+void WeightedMatching::setRounds(unsigned int rounds)
+{
+	m_rounds = rounds;
+}
+
+std::size_t WeightedMatching::calculateMatching(const WeightedGraph& graph)
+{
+	m_graph = &graph;
+
+	suitor();
+
+	for(unsigned int i = 0; i < m_rounds; ++i)
+	{
+		if(improve() == 0)
+			break;
+	}
+
+	std::size_t size = 0;
+	m_weight = 0.0;
+	for(NodeID v = 0; v < graph.numNodes(); ++v)
+	{
+		if(m_mates[v] > v)
+		{
+			size++;
+			m_weight += m_mateWeight[v];
+		}
+	}
+
+	return size;
+}
+
+namespace
+{
+	typedef WeightedGraph::Weight Weight;
+
+	const NodeID NoNode = ~NodeID(0);
+
+	//! Is the offer (weight, v) better than (otherWeight, other)?
+	inline bool isBetter(Weight weight, NodeID v, Weight otherWeight, NodeID other)
+	{
+		return weight > otherWeight || (weight == otherWeight && other != NoNode && v > other);
+	}
+}
+
+void WeightedMatching::suitor()
+{
+	const WeightedGraph& graph = *m_graph;
+	NodeID n = graph.numNodes();
+
+	// suitors[v] made the best offer offers[v] to v so far. Both are read
+	// without lock while searching and only changed while holding locks[v].
+	std::unique_ptr<std::atomic<NodeID>[]> suitors(new std::atomic<NodeID>[n]);
+	std::unique_ptr<std::atomic<Weight>[]> offers(new std::atomic<Weight>[n]);
+	std::unique_ptr<std::atomic<bool>[]> locks(new std::atomic<bool>[n]);
+
+	for(NodeID v = 0; v < n; ++v)
+	{
+		suitors[v].store(NoNode, std::memory_order_relaxed);
+		offers[v].store(0.0, std::memory_order_relaxed);
+		locks[v].store(false, std::memory_order_relaxed);
+	}
+
+	auto propose = [&](NodeID u) {
+		NodeID current = u;
+		while(current != NoNode)
+		{
+			// Find the heaviest neighbor which would accept an offer
+			NodeID partner = NoNode;
+			Weight best = 0.0;
+
+			const Weight* weights = graph.weights(current);
+			std::size_t i = 0;
+			for(NodeID v : graph.neighbors(current))
+			{
+				Weight w = weights[i++];
+				if(w <= 0.0)
+					continue;
+
+				if((partner == NoNode || w > best || (w == best && v > partner))
+					&& isBetter(w, current, offers[v].load(std::memory_order_relaxed), suitors[v].load(std::memory_order_relaxed)))
+				{
+					partner = v;
+					best = w;
+				}
+			}
+
+			if(partner == NoNode)
+				return;
+
+			while(locks[partner].exchange(true, std::memory_order_acquire))
+				;
+
+			// Someone else might have made a better offer in the meantime.
+			// Then we simply search again.
+			NodeID next = current;
+			if(isBetter(best, current, offers[partner].load(std::memory_order_relaxed), suitors[partner].load(std::memory_order_relaxed)))
+			{
+				next = suitors[partner].load(std::memory_order_relaxed);
+				suitors[partner].store(current, std::memory_order_relaxed);
+				offers[partner].store(best, std::memory_order_relaxed);
+			}
+
+			locks[partner].store(false, std::memory_order_release);
+
+			// The displaced suitor has to find a new partner
+			current = next;
+		}
+	};
+
+	// Interleave the vertices between the threads, so that high-degree
+	// vertices (often numbered first) are distributed evenly
+	unsigned int numThreads = std::max<NodeID>(1, std::min<NodeID>(m_threads, n / 1024 + 1));
+	std::vector<std::thread> threads;
+	for(unsigned int t = 1; t < numThreads; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			for(NodeID u = t; u < n; u += numThreads)
+				propose(u);
+		});
+	}
+
+	for(NodeID u = 0; u < n; u += numThreads)
+		propose(u);
+
+	for(std::thread& thread : threads)
+		thread.join();
+
+	// Mutual suitors form the matching
+	m_mates.resize(n);
+	m_mateWeight.resize(n);
+	for(NodeID v = 0; v < n; ++v)
+	{
+		NodeID s = suitors[v].load(std::memory_order_relaxed);
+		if(s != NoNode && suitors[s].load(std::memory_order_relaxed) == v)
+		{
+			m_mates[v] = s;
+			m_mateWeight[v] = offers[v].load(std::memory_order_relaxed);
+		}
+		else
+		{
+			m_mates[v] = v;
+			m_mateWeight[v] = 0.0;
+		}
+	}
+}
+
+std::size_t WeightedMatching::improve()
+{
+	const WeightedGraph& graph = *m_graph;
+	std::size_t improvements = 0;
+
+	// Heaviest edge from x to an exposed vertex other than @a exclude
+	auto bestExposed = [&](NodeID x, NodeID exclude, Weight* weight) {
+		NodeID best = NoNode;
+		*weight = 0.0;
+
+		const Weight* weights = graph.weights(x);
+		std::size_t i = 0;
+		for(NodeID y : graph.neighbors(x))
+		{
+			Weight w = weights[i++];
+			if(y != exclude && m_mates[y] == y && w > *weight)
+			{
+				best = y;
+				*weight = w;
+			}
+		}
+
+		return best;
+	};
+
+	for(NodeID u = 0; u < graph.numNodes(); ++u)
+	{
+		if(m_mates[u] != u)
+			continue;
+
+		// Find the best alternating path u - v = x (- y), which replaces
+		// the matching edge {v,x} by {u,v} (and {x,y}).
+		Weight bestGain = 0.0;
+		NodeID bestV = NoNode;
+		NodeID bestY = NoNode;
+		Weight bestUV = 0.0;
+		Weight bestXY = 0.0;
+
+		const Weight* weights = graph.weights(u);
+		std::size_t i = 0;
+		for(NodeID v : graph.neighbors(u))
+		{
+			Weight uv = weights[i++];
+			if(uv <= 0.0)
+				continue;
+
+			NodeID x = m_mates[v];
+			Weight gain = uv - m_mateWeight[v];
+			Weight xy = 0.0;
+			NodeID y = NoNode;
+
+			if(x != v)
+			{
+				y = bestExposed(x, u, &xy);
+				gain += xy;
+			}
+
+			if(gain > bestGain)
+			{
+				bestGain = gain;
+				bestV = v;
+				bestY = y;
+				bestUV = uv;
+				bestXY = xy;
+			}
+		}
+
+		if(bestV == NoNode)
+			continue;
+
+		NodeID x = m_mates[bestV];
+		if(x != bestV)
+		{
+			m_mates[x] = x;
+			m_mateWeight[x] = 0.0;
+
+			if(bestY != NoNode)
+			{
+				m_mates[x] = bestY;
+				m_mates[bestY] = x;
+				m_mateWeight[x] = bestXY;
+				m_mateWeight[bestY] = bestXY;
+			}
+		}
+
+		m_mates[u] = bestV;
+		m_mates[bestV] = u;
+		m_mateWeight[u] = bestUV;
+		m_mateWeight[bestV] = bestUV;
+
+		improvements++;
+	}
+
+	return improvements;
+}
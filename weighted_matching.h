@@ -0,0 +1,74 @@
+// Approximate maximum weight matching
+// Author: Max Schwarz <max.schwarz@uni-bonn.de>
+
+#ifndef WEIGHTED_MATCHING_H
+#define WEIGHTED_MATCHING_H
+
+#include "weighted_graph.h"
+
+/**
+ * Parallel 1/2-approximation of a maximum weight matching using the Suitor
+ * algorithm [Manne, Halappanavar 2014].
+ *
+ * Each vertex proposes to its heaviest neighbor whose current suitor made
+ * a lighter offer, displacing that suitor, which then proposes to its next
+ * best neighbor. The result is the same matching as the greedy algorithm
+ * on edges sorted by decreasing weight, but does not need sorting and
+ * parallelizes well. Ties are broken by node ID.
+ *
+ * Optionally, the matching is improved afterwards by rounds of local
+ * search, which apply weight-augmenting alternating paths with up to three
+ * edges starting at exposed vertices.
+ *
+ * Edges with non-positive weight are never matched.
+ **/
+class WeightedMatching
+{
+public:
+	WeightedMatching();
+
+	//! Number of threads for the Suitor algorithm (default: hardware concurrency)
+	void setThreads(unsigned int threads);
+
+	//! Number of local search rounds after the Suitor algorithm (default: 0)
+	void setRounds(unsigned int rounds);
+
+	/**
+	 * Calculate a matching in @a graph. The result is available through
+	 * mates() afterwards.
+	 *
+	 * @return Size of the matching
+	 **/
+	std::size_t calculateMatching(const WeightedGraph& graph);
+
+	/**
+	 * Result of the last calculateMatching() call: v is matched to
+	 * mates()[v], or unmatched if mates()[v] == v.
+	 **/
+	const LargeVector<NodeID>& mates() const
+	{ return m_mates; }
+
+	//! Total weight of the matching
+	WeightedGraph::Weight weight() const
+	{ return m_weight; }
+private:
+	//! Run the Suitor algorithm and set m_mates and m_mateWeight
+	void suitor();
+
+	//! One round of local search, returns the number of improvements
+	std::size_t improve();
+
+	const WeightedGraph* m_graph;
+
+	unsigned int m_threads;
+	unsigned int m_rounds;
+
+	LargeVector<NodeID> m_mates;
+
+	//! Weight of the matching edge at v (0 if unmatched)
+	LargeVector<WeightedGraph::Weight> m_mateWeight;
+
+	WeightedGraph::Weight m_weight;
+};
+
+#endif